@@ -0,0 +1,239 @@
+/*
+ * BinaryProtocol.cpp
+ * Created on: Oct 17, 2026
+ * Author: nicole
+ */
+
+#include "BinaryProtocol.h"
+
+/* the largest event id that fits the int event ids of the server */
+#define MAX_EVENT_ID 0x7fffffff
+
+/**
+ * @brief: encode a frame header into the BINARY_HEADER_LEN bytes at out.
+ */
+void BinaryProtocol::encodeHeader( char* out, int opcode, int status,
+                                   uint32_t requestId, uint32_t length)
+{
+    uint32_t value;
+
+    out[0] = (char) opcode;
+    out[1] = (char) status;
+    out[2] = out[3] = 0;
+    value = htonl( requestId);
+    memcpy( out + 4, &value, sizeof(value));
+    value = htonl( length);
+    memcpy( out + 8, &value, sizeof(value));
+}
+
+
+/**
+ * @brief: encode a whole frame - header followed by payload.
+ */
+std::string BinaryProtocol::encodeFrame( int opcode, int status,
+                                         uint32_t requestId,
+                                         const std::string& payload)
+{
+    char header[BINARY_HEADER_LEN];
+    std::string frame;
+
+    encodeHeader( header, opcode, status, requestId,
+                  (uint32_t) payload.size());
+
+    frame.reserve( BINARY_HEADER_LEN + payload.size());
+    frame.append( header, BINARY_HEADER_LEN);
+    frame.append( payload);
+    return frame;
+}
+
+
+/**
+ * @brief: encode the request frame of the command with its arguments.
+ */
+std::string BinaryProtocol::encodeRequest( int opcode, uint32_t requestId,
+                                           const CommandArgs& args)
+{
+    std::string payload;
+
+    switch( opcode)
+    {
+        case CREATE:
+            _appendField( payload, args.title);
+            _appendField( payload, args.date);
+            _appendField( payload, args.description);
+            break;
+
+        case SEND_RSVP:
+            appendVarint( payload, (uint64_t) args.eventId);
+            break;
+
+        case GET_RSVPS_LIST:
+            appendVarint( payload, (uint64_t) args.eventId);
+            if ( !args.cursor.empty()) {
+                _appendField( payload, args.cursor);
+                appendVarint( payload, (uint64_t) args.limit);
+            }
+            break;
+
+        case GET_TOP:
+            appendVarint( payload, (uint64_t) args.count);
+            break;
+    }
+
+    return encodeFrame( opcode, STATUS_OK, requestId, payload);
+}
+
+
+/**
+ * @brief: decode the arguments of a request payload of opcode.
+ * @return: false if the payload is malformed.
+ */
+bool BinaryProtocol::decodeArgs( int opcode, const std::string& payload,
+                                 CommandArgs& args)
+{
+    const char* pos = payload.data();
+    const char* end = pos + payload.size();
+    uint64_t eventId, count, limit;
+
+    switch( opcode)
+    {
+        case REGISTER:
+        case UNREGISTER:
+        case GET_TOP_5:
+            return true;
+
+        case CREATE:
+            return _readField( pos, end, args.title) &&
+                   _readField( pos, end, args.date) &&
+                   _readField( pos, end, args.description);
+
+        case SEND_RSVP:
+        case GET_RSVPS_LIST:
+            if ( !readVarint( pos, end, eventId) || eventId > MAX_EVENT_ID) {
+                return false;
+            }
+            args.eventId = (int) eventId;
+            if ( opcode == SEND_RSVP || pos == end) {
+                return true;
+            }
+            /* a page of the list */
+            if ( !_readField( pos, end, args.cursor) || args.cursor.empty() ||
+                 !readVarint( pos, end, limit) || limit < 1 ||
+                 limit > MAX_LIST_LIMIT) {
+                return false;
+            }
+            args.limit = (int) limit;
+            return true;
+
+        case GET_TOP:
+            if ( !readVarint( pos, end, count) || count > MAX_EVENT_ID) {
+                return false;
+            }
+            args.count = (int) count;
+            return true;
+    }
+
+    return false;
+}
+
+
+/**
+ * @brief: take the next whole frame out of the reader.
+ * @return: 1 if a frame was taken, 0 if it is not complete yet and -1
+ * if the frame is longer than MAX_REQUEST_LEN.
+ */
+int BinaryProtocol::takeFrame( RequestReader& reader, BinaryHeader& header,
+                               std::string& payload)
+{
+    const char* data = reader.peek();
+    uint32_t value;
+
+    if ( reader.available() < BINARY_HEADER_LEN) {
+        return 0;
+    }
+
+    header.opcode = (uint8_t) data[0];
+    header.status = (uint8_t) data[1];
+    memcpy( &value, data + 4, sizeof(value));
+    header.requestId = ntohl( value);
+    memcpy( &value, data + 8, sizeof(value));
+    header.length = ntohl( value);
+
+    if ( header.length > MAX_REQUEST_LEN) {
+        return -1;
+    }
+    if ( reader.available() < BINARY_HEADER_LEN + header.length) {
+        return 0;
+    }
+
+    payload.assign( data + BINARY_HEADER_LEN, header.length);
+    reader.consume( BINARY_HEADER_LEN + header.length);
+    return 1;
+}
+
+
+/**
+ * @brief: append value as an unsigned LEB128 varint.
+ */
+void BinaryProtocol::appendVarint( std::string& out, uint64_t value)
+{
+    while ( value >= 0x80) {
+        out.push_back( (char) ((value & 0x7f) | 0x80));
+        value >>= 7;
+    }
+    out.push_back( (char) value);
+}
+
+
+/**
+ * @brief: read a varint at pos, advancing pos.
+ * @return: false if the varint runs past end.
+ */
+bool BinaryProtocol::readVarint( const char*& pos, const char* end,
+                                 uint64_t& value)
+{
+    unsigned int shift = 0;
+    uint8_t byte;
+
+    value = 0;
+    while ( pos < end && shift < 64)
+    {
+        byte = (uint8_t) *pos++;
+        value |= (uint64_t) (byte & 0x7f) << shift;
+        if ( (byte & 0x80) == 0) {
+            return true;
+        }
+        shift += 7;
+    }
+    return false;
+}
+
+/*************** Private Functions **************************************/
+
+/**
+ * @brief: append a varint length prefixed field.
+ */
+void BinaryProtocol::_appendField( std::string& out, StrRef field)
+{
+    appendVarint( out, field.size);
+    out.append( field.data, field.size);
+}
+
+
+/**
+ * @brief: read a varint length prefixed field at pos, advancing pos - the
+ * field is a slice of the payload, not a copy.
+ * @return: false if the field runs past end.
+ */
+bool BinaryProtocol::_readField( const char*& pos, const char* end,
+                                 StrRef& field)
+{
+    uint64_t length;
+
+    if ( !readVarint( pos, end, length) || length > (uint64_t) (end - pos)) {
+        return false;
+    }
+    field = StrRef( pos, length);
+    pos += length;
+    return true;
+}
@@ -0,0 +1,115 @@
+/*
+ * BinaryProtocol.h
+ * Created on: Oct 17, 2026
+ * Author: nicole
+ */
+
+#ifndef BINARYPROTOCOL_H_
+#define BINARYPROTOCOL_H_
+
+#include <stdint.h>
+#include <string>
+#include <string.h>
+#include <arpa/inet.h> // htonl, ntohl
+
+#include "CommandParser.h"
+#include "RequestReader.h"
+
+/* fixed frame header: opcode(1) status(1) reserved(2) request id(4)
+ * payload length(4), multi byte fields in network byte order */
+#define BINARY_HEADER_LEN 12
+
+
+/**
+ * header of a binary protocol frame - the same for requests and responses.
+ */
+struct BinaryHeader
+{
+    uint8_t opcode;     /* command type according to the Commands enum */
+    uint8_t status;     /* ResponseStatus in responses, 0 in requests */
+    uint32_t requestId; /* chosen by the client, echoed in the response */
+    uint32_t length;    /* payload length */
+};
+
+
+/**
+ * Encoding and decoding of the compact binary wire protocol, negotiated by
+ * opening the session with BINARY <client name>\n instead of SESSION. Every
+ * request and response is a fixed header followed by the payload. request
+ * fields are varint length prefixed strings (CREATE: title, date,
+ * description), a varint event id (SEND_RSVP, GET_RSVPS_LIST - for a page
+ * followed by the cursor string and a varint limit) or a varint count
+ * (GET_TOP), so the server never tokenizes a command line. a response
+ * payload is the response body and its status code is in the header.
+ */
+class BinaryProtocol
+{
+public:
+
+    /**
+     * @brief: encode a frame header into the BINARY_HEADER_LEN bytes at out.
+     */
+    static void encodeHeader( char* out, int opcode, int status,
+                              uint32_t requestId, uint32_t length);
+
+    /**
+     * @brief: encode a whole frame - header followed by payload.
+     */
+    static std::string encodeFrame( int opcode, int status, uint32_t requestId,
+                                    const std::string& payload);
+
+    /**
+     * @brief: encode the request frame of the command with its arguments.
+     */
+    static std::string encodeRequest( int opcode, uint32_t requestId,
+                                      const CommandArgs& args);
+
+    /**
+     * @brief: decode the arguments of a request payload of opcode - the
+     * string arguments are slices of payload.
+     * @return: false if the payload is malformed.
+     */
+    static bool decodeArgs( int opcode, const std::string& payload,
+                            CommandArgs& args);
+
+    /**
+     * @brief: take the next whole frame out of the reader.
+     * @return: 1 if a frame was taken, 0 if it is not complete yet and -1
+     * if the frame is longer than MAX_REQUEST_LEN.
+     */
+    static int takeFrame( RequestReader& reader, BinaryHeader& header,
+                          std::string& payload);
+
+    /**
+     * @brief: append value as an unsigned LEB128 varint.
+     */
+    static void appendVarint( std::string& out, uint64_t value);
+
+    /**
+     * @brief: read a varint at pos, advancing pos.
+     * @return: false if the varint runs past end.
+     */
+    static bool readVarint( const char*& pos, const char* end,
+                            uint64_t& value);
+
+private:
+
+    /**
+     * @brief: append a varint length prefixed field.
+     */
+    static void _appendField( std::string& out, StrRef field);
+
+    /**
+     * @brief: read a varint length prefixed field at pos, advancing pos.
+     * @return: false if the field runs past end.
+     */
+    static bool _readField( const char*& pos, const char* end,
+                            StrRef& field);
+
+    /**
+     * private constructor - static helper functions only.
+     */
+    BinaryProtocol();
+};
+
+#endif /* BINARYPROTOCOL_H_ */
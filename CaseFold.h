@@ -0,0 +1,158 @@
+/*
+ * CaseFold.h
+ * Created on: Oct 17, 2026
+ * Author: nicole
+ */
+
+#ifndef CASEFOLD_H_
+#define CASEFOLD_H_
+
+#include <stdint.h>
+#include <string.h> // memcpy
+#include <string>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+/* multiplier of the name hash mix (64 bit golden ratio) */
+#define CASE_HASH_MUL 0x9E3779B97F4A7C15ULL
+
+
+/**
+ * Case insensitive (ASCII) hashing and comparison of client names without
+ * an upper case copy of the name. With SSE2 16 bytes are folded at once,
+ * otherwise 8 - both fold the same words, so the hash does not depend on
+ * the path taken.
+ */
+class CaseFold
+{
+public:
+
+    /**
+     * @return: hash of the upper case name.
+     */
+    static size_t hash( const char* name, size_t len) {
+        uint64_t h = len * CASE_HASH_MUL;
+        uint64_t words[2];
+        size_t i = 0;
+
+#ifdef __SSE2__
+        for ( ; i + 16 <= len; i += 16) {
+            _mm_storeu_si128( (__m128i*) words, _fold16( name + i));
+            h = _mix( _mix( h, words[0]), words[1]);
+        }
+#endif
+        for ( ; i + 8 <= len; i += 8) {
+            h = _mix( h, _fold8( name + i, 8));
+        }
+        if ( i < len) {
+            h = _mix( h, _fold8( name + i, len - i));
+        }
+        return (size_t) (h ^ (h >> 32));
+    }
+
+    /**
+     * @return: true if the names are equal ignoring the (ASCII) case.
+     */
+    static bool equal( const char* a, const char* b, size_t len) {
+        size_t i = 0;
+
+#ifdef __SSE2__
+        for ( ; i + 16 <= len; i += 16) {
+            if ( _mm_movemask_epi8( _mm_cmpeq_epi8( _fold16( a + i),
+                                                    _fold16( b + i)))
+                 != 0xFFFF) {
+                return false;
+            }
+        }
+#endif
+        for ( ; i < len; ++i) {
+            if ( _upper( a[i]) != _upper( b[i])) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief: upper case name in place.
+     */
+    static void toUpper( std::string& name) {
+        std::string::iterator it;
+
+        for ( it = name.begin(); it != name.end(); ++it) {
+            *it = _upper( *it);
+        }
+    }
+
+private:
+
+    CaseFold() {}
+
+    static char _upper( char c) {
+        return (c >= 'a' && c <= 'z') ? (char) (c - ('a' - 'A')) : c;
+    }
+
+    static uint64_t _mix( uint64_t h, uint64_t word) {
+        h = (h ^ word) * CASE_HASH_MUL;
+        return h ^ (h >> 29);
+    }
+
+    /**
+     * @return: len (at most 8) upper cased bytes as a zero padded word.
+     */
+    static uint64_t _fold8( const char* p, size_t len) {
+        char bytes[8] = { 0 };
+        uint64_t word;
+        size_t i;
+
+        for ( i = 0; i < len; ++i) {
+            bytes[i] = _upper( p[i]);
+        }
+        memcpy( &word, bytes, sizeof( word));
+        return word;
+    }
+
+#ifdef __SSE2__
+    /**
+     * @return: 16 upper cased bytes - a byte is lower case if its distance
+     * from 'a' is at most 25 (compared unsigned).
+     */
+    static __m128i _fold16( const char* p) {
+        __m128i v = _mm_loadu_si128( (const __m128i*) p);
+        __m128i fromA = _mm_sub_epi8( v, _mm_set1_epi8( 'a'));
+        __m128i lower = _mm_cmpeq_epi8( _mm_min_epu8( fromA,
+                                                      _mm_set1_epi8( 25)),
+                                        fromA);
+
+        return _mm_sub_epi8( v, _mm_and_si128( lower,
+                                               _mm_set1_epi8( 'a' - 'A')));
+    }
+#endif
+};
+
+
+/**
+ * case insensitive hasher of client names, for the unordered containers.
+ */
+struct CaseInsensitiveHash
+{
+    size_t operator()( const std::string& name) const {
+        return CaseFold::hash( name.data(), name.size());
+    }
+};
+
+
+/**
+ * case insensitive equality of client names, for the unordered containers.
+ */
+struct CaseInsensitiveEqual
+{
+    bool operator()( const std::string& a, const std::string& b) const {
+        return a.size() == b.size() &&
+               CaseFold::equal( a.data(), b.data(), a.size());
+    }
+};
+
+#endif /* CASEFOLD_H_ */
@@ -8,6 +8,83 @@
 
 /*************** Private Functions **************************************/
 
+/**
+ * @brief: take the oldest sent command that waits for a response.
+ */
+void Client::_popPending()
+{
+    if ( !_pending.empty()) {
+        _commandType = _pending.front().commandType;
+        eventIdSent = _pending.front().eventIdSent;
+        eventIdRequest = _pending.front().eventIdRequest;
+        _topCount = _pending.front().topCount;
+        _listCursor = _pending.front().listCursor;
+        _listLimit = _pending.front().listLimit;
+        _pending.pop_front();
+    }
+}
+
+
+/**
+ * @brief: status of a text protocol response: every error response of the
+ * server starts with "ERROR: " and a RSVP that is neither an error nor
+ * SUCCESS was already sent.
+ * @return: the response ResponseStatus.
+ */
+int Client::_responseStatus( const std::string& response) const
+{
+    std::size_t foundError = response.find( "ERROR: ");
+
+    if ( foundError != std::string::npos) {
+        return STATUS_ERROR;
+    }
+    if ( _commandType == SEND_RSVP &&
+         response.find( "SUCCESS") == std::string::npos) {
+        return STATUS_ALREADY;
+    }
+    return STATUS_OK;
+}
+
+
+/**
+ * @brief: pass the response to the log method of the last command type.
+ */
+void Client::_logResponse( int status, const std::string& response)
+{
+    /* log server response according to the last command type user requested*/
+    switch( _commandType)
+    {
+        case REGISTER:
+            logRegister_response( status, response);
+            break;
+
+        case CREATE:
+            logCreate_response( status, response);
+            break;
+
+        case UNREGISTER:
+            logUnregister_response( status, response);
+            break;
+
+        case SEND_RSVP:
+            logRSVP_response( status, response);
+            break;
+
+        case GET_RSVPS_LIST:
+            logEventList_response( status, response);
+            break;
+
+        case GET_TOP_5:
+            logGetTop5_response( status, response);
+            break;
+
+        case GET_TOP:
+            logGetTop_response( status, response);
+            break;
+    }
+}
+
+
 
 /*************** Public Functions **************************************/
 
@@ -16,7 +93,7 @@
  */
 Client::Client( const std::string clientName): eventIdSent(0),
         eventIdRequest(0), clientName( clientName), _registered(false),
-        _commandType(0)
+        _commandType(0), _registerSent(false), _topCount(0), _listLimit(0)
 {
     time_t current_time;
     struct tm * time_info;
@@ -68,33 +145,28 @@ void Client::logClientError( std::string func, std::string desc)
  * and the arguments chars length is valid.
  * @return: true is client request command from server is valid.
  */
-bool Client::validateCommand( char* buffer)
+bool Client::validateCommand( const char* buffer)
 {
-    std::vector<std::string> tokens;
-    std::string commLine( buffer);
+    StrRef tokens[MAX_COMMAND_TOKENS];
+    StrRef line( buffer, strlen( buffer));
+    StrRef description;
     std::string errMsg;
-    CommandParser::tokenize( commLine, " ", tokens);
-    std::string command = tokens[0];
-    size_t hasNewLine = 0;
-    size_t found = command.find("\n");
-    if (found != std::string::npos) {
-        command = command.substr( 0, found);
-    }
-    /* transform first command word to upper case */
-    std::transform( command.begin(), command.end(),command.begin(), ::toupper);
-    _commandType = CommandParser::getCommandType( command);
+    size_t numTokens = CommandParser::tokenize( line, ' ', tokens,
+                                                MAX_COMMAND_TOKENS);
+    _commandType = CommandParser::getCommandType( tokens[0]);
+    const std::string& command = CommandParser::commandName( _commandType);
     bool valid = true;
 
     switch( _commandType)
     {
         case REGISTER:
             /* REGISTER has no arguments */
-            if (tokens.size() > 1) {
+            if (numTokens > 1) {
                 errMsg = CommandParser::logCommandError( clientName, MISS_ARGS,
                                                          command);
                 valid = false;
             }
-            if ( _registered) { // if it's true then client already registered
+            if ( _registered || _registerSent) { // client already registered
                 errMsg = CommandParser::logCommandError( clientName,
                                                          ALREADY_REGISTER);
                 valid = false;
@@ -102,47 +174,50 @@ bool Client::validateCommand( char* buffer)
             break;
 
         case CREATE:
-            if ( !_registered) { // if false then client didn't register yet
+            if ( !_registered && !_registerSent) { // didn't register yet
                 errMsg =CommandParser::logCommandError(clientName,NO_REGISTER);
                 valid = false;
             }
 
-            if (tokens.size() < 4) {
+            if (numTokens < 4) {
                 errMsg = CommandParser::logCommandError( clientName, MISS_ARGS,
                                                          command);
                 valid = false;
 
             } else {
-                if (tokens[1].length() > MAX_TITLE) {
+                if (tokens[1].size > MAX_TITLE) {
                     errMsg = CommandParser::logCommandError( clientName,
-                             INVALID_ARG_COMMAND, command, tokens[1]);
+                             INVALID_ARG_COMMAND, command, tokens[1].str());
                     valid = false;
                 }
 
-                if ( tokens[2].length() > MAX_DATE) {
+                if ( tokens[2].size > MAX_DATE) {
                     errMsg = CommandParser::logCommandError( clientName,
-                             INVALID_ARG_COMMAND, command, tokens[2]);
+                             INVALID_ARG_COMMAND, command, tokens[2].str());
                     valid = false;
                 }
 
-                if ( tokens.size() > 4) {
-                    CommandParser::joinTokens( tokens, " ", 3);
-                }
-                if ( tokens[3].length() > MAX_DESC) {
+                /* the description is the rest of the line */
+                description = CommandParser::restOfLine( line, tokens[3],
+                                                         ' ');
+                if ( description.size > MAX_DESC) {
                     errMsg = CommandParser::logCommandError( clientName,
-                             INVALID_ARG_COMMAND, command, tokens[3]);
+                             INVALID_ARG_COMMAND, command, description.str());
                     valid = false;
                 }
+                _args.title = tokens[1];
+                _args.date = tokens[2];
+                _args.description = description;
             }
             break;
 
         case UNREGISTER:
-            if ( !_registered) { // if false then client didn't register yet
+            if ( !_registered && !_registerSent) { // didn't register yet
                 errMsg =CommandParser::logCommandError(clientName,NO_REGISTER);
                 valid = false;
             }
 
-            if (tokens.size() > 1) {
+            if (numTokens > 1) {
                 errMsg = CommandParser::logCommandError( clientName, MISS_ARGS,
                                                          command);
                 valid = false;
@@ -150,70 +225,100 @@ bool Client::validateCommand( char* buffer)
             break;
 
         case SEND_RSVP:
-            if ( !_registered) { // if false then client didn't register yet
+            if ( !_registered && !_registerSent) { // didn't register yet
                 errMsg =CommandParser::logCommandError(clientName,NO_REGISTER);
                 valid = false;
             }
             /* should have an evendId numeric string */
-            if (tokens.size() < 2) {
+            if (numTokens < 2) {
                 errMsg = CommandParser::logCommandError( clientName, MISS_ARGS,
                                                          command);
                 valid = false;
 
             } else {
-                hasNewLine = tokens[1].find("\n");
-                if (hasNewLine != std::string::npos){
-                    tokens[1] = tokens[1].substr( 0, hasNewLine);
-                }
-
-                if ( CommandParser::isStrNumber( tokens[1])) {
-                    eventIdSent = stoi( tokens[1]);
+                if ( CommandParser::toNumber( tokens[1], eventIdSent)) {
+                    _args.eventId = eventIdSent;
                 } else {
                     errMsg = CommandParser::logCommandError( clientName,
-                            INVALID_ARG_COMMAND, command, tokens[1]);
+                            INVALID_ARG_COMMAND, command, tokens[1].str());
                     valid = false;
                 }
             }
             break;
 
         case GET_RSVPS_LIST:
-            if ( !_registered) { // if false then client didn't register yet
+            if ( !_registered && !_registerSent) { // didn't register yet
                 errMsg =CommandParser::logCommandError(clientName,NO_REGISTER);
                 valid = false;
             }
             /* should have an evendId numeric string */
-            if (tokens.size() < 2) {
+            if (numTokens < 2) {
                 errMsg = CommandParser::logCommandError( clientName, MISS_ARGS,
                                                          command);
                 valid = false;
 
             } else {
-                hasNewLine = tokens[1].find("\n");
-                if (hasNewLine != std::string::npos){
-                    tokens[1] = tokens[1].substr( 0, hasNewLine);
-                }
-                if ( CommandParser::isStrNumber( tokens[1])) {
-                    eventIdRequest = stoi( tokens[1]);
+                if ( CommandParser::toNumber( tokens[1], eventIdRequest)) {
+                    _args.eventId = eventIdRequest;
                 } else {
                     errMsg = CommandParser::logCommandError( clientName,
-                             INVALID_ARG_COMMAND, command, tokens[1]);
+                             INVALID_ARG_COMMAND, command, tokens[1].str());
+                    valid = false;
+                }
+            }
+            /* GET_RSVPS_LIST <id> <cursor> [limit] - a page of the list */
+            _listCursor.clear();
+            if ( numTokens > 2) {
+                _listCursor = tokens[2].str();
+                _listLimit = DEFAULT_LIST_LIMIT;
+            }
+            if ( numTokens > 3) {
+                if ( !CommandParser::toNumber( tokens[3], _listLimit) ||
+                     _listLimit < 1 || _listLimit > MAX_LIST_LIMIT) {
+                    errMsg = CommandParser::logCommandError( clientName,
+                             INVALID_ARG_COMMAND, command, tokens[3].str());
                     valid = false;
                 }
             }
+            _args.cursor = _listCursor;
+            _args.limit = _listLimit;
             break;
 
         case GET_TOP_5:
-            if ( !_registered) { // if false then client didn't register yet
+            if ( !_registered && !_registerSent) { // didn't register yet
                 errMsg =CommandParser::logCommandError(clientName,NO_REGISTER);
                 valid = false;
             }
-            if (tokens.size() > 1) {
+            if (numTokens > 1) {
                 errMsg = CommandParser::logCommandError( clientName, MISS_ARGS,
                                                          command);
                 valid = false;
             }
             break;
 
+        case GET_TOP:
+            if ( !_registered && !_registerSent) { // didn't register yet
+                errMsg =CommandParser::logCommandError(clientName,NO_REGISTER);
+                valid = false;
+            }
+            /* should have a positive count numeric string */
+            if (numTokens < 2) {
+                errMsg = CommandParser::logCommandError( clientName, MISS_ARGS,
+                                                         command);
+                valid = false;
+
+            } else {
+                if ( CommandParser::toNumber( tokens[1], _topCount) &&
+                     _topCount > 0) {
+                    _args.count = _topCount;
+                } else {
+                    errMsg = CommandParser::logCommandError( clientName,
+                             INVALID_ARG_COMMAND, command, tokens[1].str());
+                    valid = false;
+                }
+            }
+            break;
+
         case ILLEGAL:
             errMsg = CommandParser::logCommandError( clientName,
                                                      COMMAND_NOTEXIST);
@@ -233,6 +338,29 @@ bool Client::validateCommand( char* buffer)
 }
 
 
+/**
+ * @brief: remember the last validated command as sent to the server, so
+ * its response is logged correctly even when more commands were sent
+ * (pipelined) before the response arrived.
+ */
+void Client::commandSent()
+{
+    PendingCommand command;
+
+    command.commandType = _commandType;
+    command.eventIdSent = eventIdSent;
+    command.eventIdRequest = eventIdRequest;
+    command.topCount = _topCount;
+    command.listCursor = _listCursor;
+    command.listLimit = _listLimit;
+    _pending.push_back( command);
+
+    if ( _commandType == REGISTER) {
+        _registerSent = true;
+    }
+}
+
+
 /**
  * @brief: get server response for client request - then identify it's
  * command type and pass it to the relevant log response method for final
@@ -240,44 +368,31 @@ bool Client::validateCommand( char* buffer)
  */
 void Client::log_response( const std::string response)
 {
-    /* log server response according to the last command type user requested*/
-    switch( _commandType)
-    {
-        case REGISTER:
-            logRegister_response( response);
-            break;
-
-        case CREATE:
-            logCreate_response( response);
-            break;
-
-        case UNREGISTER:
-            logUnregister_response( response);
-            break;
-
-        case SEND_RSVP:
-            logRSVP_response( response);
-            break;
+    /* responses arrive in the order the commands were sent */
+    _popPending();
+    _logResponse( _responseStatus( response), response);
+}
 
-        case GET_RSVPS_LIST:
-            logEventList_response( response);
-            break;
 
-        case GET_TOP_5:
-            logGetTop5_response( response);
-            break;
-    }
+/**
+ * @brief: log a binary protocol response - the status code comes in the
+ * frame header, so the response text is not searched.
+ */
+void Client::log_binary_response( int status, const std::string response)
+{
+    _popPending();
+    _logResponse( status, response);
 }
 
 
 /**
  * @brief: log in client log the server response about REGISTER.
  */
-void Client::logRegister_response( const std::string response)
+void Client::logRegister_response( int status, const std::string response)
 {
     std::string logClient;
 
-    if ( response.find( "ERROR: ") != std::string::npos) {
+    if ( status != STATUS_OK) {
         logClient = "ERROR: the client " + clientName + CLIENT_REGISTERED;
         _registered = false;
         delete _logger; /* first close and delete logger instance */
@@ -285,7 +400,7 @@ void Client::logRegister_response( const std::string response)
          * client name, it's program should exit */
         exit(0);
 
-    } else if ( response.find( "SUCCESS") != std::string::npos) {
+    } else {
         _registered = true;
         logClient = "Client " + clientName + REGISTER_SUCCESS;
     }
@@ -297,15 +412,15 @@ void Client::logRegister_response( const std::string response)
 /**
  * @brief: log in client log the server response about UNREGISTER.
  */
-void Client::logUnregister_response( const std::string response)
+void Client::logUnregister_response( int status, const std::string response)
 {
     std::string logClient;
 
-    if (response.find( "ERROR: ") != std::string::npos) {
+    if ( status != STATUS_OK) {
         logClient = "ERROR: failed to unregister client " + clientName + ".";
         logToClient( logClient);
 
-    } else if (response.find( "SUCCESS") != std::string::npos) {
+    } else {
         logClient = "Client " + clientName + " was unregistered successfully.";
         logToClient( logClient);
         _registered = false;
@@ -318,21 +433,12 @@ void Client::logUnregister_response( const std::string response)
 /**
  * @brief: log in client log the server response about CREATE.
  */
-void Client::logCreate_response( const std::string response)
+void Client::logCreate_response( int status, const std::string response)
 {
-    std::string eventId = response;
-    std::string logClient, errMsg;
-    std::size_t foundError;
-
-    foundError = response.find( "ERROR: ");
-
-    if (foundError != std::string::npos) {
-        errMsg = response.substr( foundError);
-        logClient = "ERROR: failed to create the event:" + errMsg;
-
-    } else if ( response.find("REGISTER") != std::string::npos) {
-        logClient = NOT_REGISTERED;
+    std::string logClient;
 
+    if ( status != STATUS_OK) {
+        logClient = "ERROR: failed to create the event:" + response;
     } else {
         logClient = response;
     }
@@ -344,26 +450,19 @@ void Client::logCreate_response( const std::string response)
 /**
  * @brief: log in client log the server response about SEND_RSVP.
  */
-void Client::logRSVP_response( const std::string response)
+void Client::logRSVP_response( int status, const std::string response)
 {
     std::string eventID = std::to_string( eventIdSent);
-    std::string eventId = response;
-    std::string logClient, errMsg;
-    std::size_t foundError;
-
-    foundError = response.find( "ERROR: ");
-
-    if (foundError != std::string::npos) {
-        errMsg = response.substr( foundError);
-        logClient="ERROR: failed to send RSVP to event id "+eventID+": "+errMsg;
-    } else if ( response.find("REGISTER") != std::string::npos) {
-        logClient = NOT_REGISTERED;
+    std::string logClient;
 
-    } else if (response.find("SUCCESS") != std::string::npos) {
+    if ( status == STATUS_OK) {
         logClient = "RSVP to event id "+eventID+" was received successfully.";
 
-    } else {
+    } else if ( status == STATUS_ALREADY) {
         logClient = "RSVP to event id " + eventID + " was already sent.";
+
+    } else {
+        logClient="ERROR: failed to send RSVP to event id "+eventID+": "+response;
     }
 
     logToClient( logClient);
@@ -373,22 +472,28 @@ void Client::logRSVP_response( const std::string response)
 /**
  * @brief: log in client log the server response about GET_RSVPS_LIST.
  */
-void Client::logEventList_response( const std::string response)
+void Client::logEventList_response( int status, const std::string response)
 {
-    std::string eventID = std::to_string( eventIdSent);
-    std::string eventId = response;
-    std::string logClient, errMsg;
-    std::size_t foundError;
-
-    foundError = response.find( "ERROR: ");
-
-    if (foundError != std::string::npos) {
-        errMsg = response.substr( foundError);
-        logClientError("GET_RSVPS_LIST", errMsg);
-
-    } else if (response.find("REGISTER") != std::string::npos) {
-        logClient = NOT_REGISTERED;
+    std::string eventID = std::to_string( eventIdRequest);
+    std::string logClient, next;
+    size_t tab;
+
+    if ( status != STATUS_OK) {
+        logClientError("GET_RSVPS_LIST", response);
+
+    } else if ( !_listCursor.empty()) {
+        /* a page: <next cursor>\t<names> - no next cursor after the last */
+        tab = response.find( '\t');
+        next = response.substr( 0, tab == std::string::npos ? 0 : tab);
+        logClient = "The RSVP's list for event id " + eventID + " after " +
+                    _listCursor + " is: " +
+                    response.substr( tab == std::string::npos ? 0 : tab + 1) +
+                    ".";
         logToClient( logClient);
+        if ( !next.empty()) {
+            _nextPage = "GET_RSVPS_LIST " + eventID + " " + next + " " +
+                        std::to_string( _listLimit);
+        }
 
     } else {
         logClient="The RSVP's list for event id "+eventID+" is: "+response+".";
@@ -397,28 +502,53 @@ void Client::logEventList_response( const std::string response)
 }
 
 
+/**
+ * @brief: after a page of GET_RSVPS_LIST that is not the last one, take
+ * the command of the next page - the list is read page after page, each of
+ * bounded size.
+ * @return: false if there is no next page to request.
+ */
+bool Client::takeNextPage( std::string& command)
+{
+    if ( _nextPage.empty()) {
+        return false;
+    }
+    command = std::move( _nextPage);
+    _nextPage.clear();
+    return true;
+}
+
+
 /**
  * @brief: log in client log the server response about GET_TOP_5.
  */
-void Client::logGetTop5_response( const std::string response)
+void Client::logGetTop5_response( int status, const std::string response)
 {
-    std::string eventID = std::to_string( eventIdSent);
-    std::string eventId = response;
-    std::string logClient, errMsg;
-    std::size_t foundError;
-    logClient = "Top 5 newest events are:\n<list of events>.\n";
+    std::string logClient;
 
-    foundError = response.find( "ERROR: ");
+    if ( status != STATUS_OK) {
+        logClient = "ERROR: failed to receive top 5 newest events: " + response;
+    } else {
+        logClient = "Top 5 newest events are:\n" + response;
+    }
 
-    if (foundError != std::string::npos) {
-        errMsg = response.substr( foundError);
-        logClient = "ERROR: failed to receive top 5 newest events: " + errMsg;
+    logToClient( logClient);
+}
 
-    } else if (response.find("REGISTER") != std::string::npos) {
-        logClient = NOT_REGISTERED;
 
+/**
+ * @brief: log in client log the server response about GET_TOP.
+ */
+void Client::logGetTop_response( int status, const std::string response)
+{
+    std::string count = std::to_string( _topCount);
+    std::string logClient;
+
+    if ( status != STATUS_OK) {
+        logClient = "ERROR: failed to receive top " + count +
+                    " newest events: " + response;
     } else {
-        logClient = "Top 5 newest events are:\n" + response;
+        logClient = "Top " + count + " newest events are:\n" + response;
     }
 
     logToClient( logClient);
@@ -19,6 +19,7 @@
 #include <iostream>     // std::cout
 #include <sstream>      // std::stringstream, std::stringbuf
 #include <algorithm> // sort,distance, find_if, copy_if
+#include <deque>
 
 #include "Logger.h"
 #include "CommandParser.h"
@@ -68,7 +69,15 @@ public:
      * and the arguments chars length is valid.
      * @return: true is client request command from server is valid.
      */
-    bool validateCommand( char* buffer);
+    bool validateCommand( const char* buffer);
+
+
+    /**
+     * @brief: remember the last validated command as sent to the server, so
+     * its response is logged correctly even when more commands were sent
+     * (pipelined) before the response arrived.
+     */
+    void commandSent();
 
 
     /**
@@ -78,36 +87,69 @@ public:
      */
     void log_response( const std::string response);
 
+    /**
+     * @brief: log a binary protocol response - the status code comes in the
+     * frame header, so the response text is not searched.
+     */
+    void log_binary_response( int status, const std::string response);
+
+    /**
+     * @brief: after a page of GET_RSVPS_LIST that is not the last one, take
+     * the command of the next page.
+     * @return: false if there is no next page to request.
+     */
+    bool takeNextPage( std::string& command);
+
+    /**
+     * @return: the command type of the last validated command.
+     */
+    int getCommandType() const {
+        return _commandType;
+    }
+
+    /**
+     * @return: the arguments of the last validated command.
+     */
+    const CommandArgs& getCommandArgs() const {
+        return _args;
+    }
+
+    /* each log method gets the response ResponseStatus and text */
 
     /**
      * @brief: log in client log the server response about REGISTER.
      */
-    void logRegister_response( const std::string response);
+    void logRegister_response( int status, const std::string response);
 
     /**
      * @brief: log in client log the server response about UNREGISTER.
      */
-    void logUnregister_response( const std::string response);
+    void logUnregister_response( int status, const std::string response);
 
     /**
      * @brief: log in client log the server response about CREATE.
      */
-    void logCreate_response( const std::string response);
+    void logCreate_response( int status, const std::string response);
 
     /**
      * @brief: log in client log the server response about SEND_RSVP.
      */
-    void logRSVP_response( const std::string response);
+    void logRSVP_response( int status, const std::string response);
 
     /**
      * @brief: log in client log the server response about GET_RSVPS_LIST.
      */
-    void logEventList_response( const std::string response);
+    void logEventList_response( int status, const std::string response);
 
     /**
      * @brief: log in client log the server response about GET_TOP_5.
      */
-    void logGetTop5_response( const std::string response);
+    void logGetTop5_response( int status, const std::string response);
+
+    /**
+     * @brief: log in client log the server response about GET_TOP.
+     */
+    void logGetTop_response( int status, const std::string response);
 
 
 private:
@@ -115,6 +157,42 @@ private:
 	Logger *_logger; /* instance of logger for the client */
 	bool _registered; /*flag to indicate if client already was registered*/
 	int _commandType; /* the last request command type code */
+	bool _registerSent; /* REGISTER was sent and its response is pending */
+	int _topCount; /* the count of events this client requested in GET_TOP */
+	std::string _listCursor; /* of the requested RSVP list page, or empty */
+	int _listLimit; /* names in the requested RSVP list page */
+	std::string _nextPage; /* command of the next RSVP list page, or empty */
+
+	/**
+	 * a command sent to the server that waits for its response.
+	 */
+	struct PendingCommand
+	{
+	    int commandType;
+	    int eventIdSent;
+	    int eventIdRequest;
+	    int topCount;
+	    std::string listCursor;
+	    int listLimit;
+	};
+
+	std::deque<PendingCommand> _pending; /* sent commands in sending order */
+	CommandArgs _args; /* arguments of the last validated command */
+
+	/**
+	 * @brief: take the oldest sent command that waits for a response.
+	 */
+	void _popPending();
+
+	/**
+	 * @return: the ResponseStatus of a text protocol response.
+	 */
+	int _responseStatus( const std::string& response) const;
+
+	/**
+	 * @brief: pass the response to the log method of the last command type.
+	 */
+	void _logResponse( int status, const std::string& response);
 
 };
 
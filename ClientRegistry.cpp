@@ -0,0 +1,95 @@
+/*
+ * ClientRegistry.cpp
+ * Created on: Oct 17, 2026
+ * Author: nicole
+ */
+
+#include "ClientRegistry.h"
+
+ClientRegistry::ClientRegistry()
+{}
+
+
+ClientRegistry::~ClientRegistry()
+{}
+
+
+/**
+ * @brief: register the client.
+ * @return: false if the client is already registered.
+ */
+bool ClientRegistry::add( NameId client)
+{
+    Shard& shard = _shardOf( client);
+    WriteGuard guard( shard.lock);
+
+    return shard.clients.insert( std::make_pair( client,
+                                                 std::vector<int>())).second;
+}
+
+
+/**
+ * @brief: unregister the client.
+ * @param events: set to the ids of the events the client sent a RSVP to.
+ * @return: false if the client is not registered.
+ */
+bool ClientRegistry::remove( NameId client, std::vector<int>& events)
+{
+    Shard& shard = _shardOf( client);
+    std::map<NameId, std::vector<int> >::iterator it;
+    WriteGuard guard( shard.lock);
+
+    it = shard.clients.find( client);
+    if ( it == shard.clients.end()) {
+        return false;
+    }
+    events.swap( it->second);
+    shard.clients.erase( it);
+    return true;
+}
+
+
+/**
+ * @brief: index that the client sent a RSVP to the event.
+ * @return: false if the client is not registered (anymore).
+ */
+bool ClientRegistry::addEvent( NameId client, int eventId)
+{
+    Shard& shard = _shardOf( client);
+    std::map<NameId, std::vector<int> >::iterator it;
+    WriteGuard guard( shard.lock);
+
+    it = shard.clients.find( client);
+    if ( it == shard.clients.end()) {
+        return false;
+    }
+    it->second.push_back( eventId);
+    return true;
+}
+
+
+/**
+ * @return: true if the client is registered.
+ */
+bool ClientRegistry::contains( NameId client)
+{
+    Shard& shard = _shardOf( client);
+    ReadGuard guard( shard.lock);
+
+    return shard.clients.find( client) != shard.clients.end();
+}
+
+
+/**
+ * @brief: unregister all the clients.
+ */
+void ClientRegistry::clear()
+{
+    int i;
+
+    for ( i = 0; i < NUM_CLIENT_SHARDS; ++i)
+    {
+        WriteGuard guard( _shards[i].lock);
+        _shards[i].clients.clear();
+    }
+}
@@ -0,0 +1,86 @@
+/*
+ * ClientRegistry.h
+ * Created on: Oct 17, 2026
+ * Author: nicole
+ */
+
+#ifndef CLIENTREGISTRY_H_
+#define CLIENTREGISTRY_H_
+
+#include <vector>
+#include <map>
+
+#include "RWLock.h"
+#include "NameTable.h"
+
+/* number of client name shards - a power of two */
+#define NUM_CLIENT_SHARDS 16
+
+
+/**
+ * A concurrent registry of the registered clients, by their interned name
+ * ids and sharded by id. Each shard has its own reader/writer lock, so
+ * the registration check done by every command reads in parallel. each
+ * client has a reverse index of the events it sent a RSVP to, so
+ * unregistering it touches only those events.
+ */
+class ClientRegistry
+{
+public:
+
+    ClientRegistry();
+
+    virtual ~ClientRegistry();
+
+    ClientRegistry( ClientRegistry const &other) = delete;
+    void operator=( ClientRegistry const &other) = delete;
+
+    /**
+     * @brief: register the client.
+     * @return: false if the client is already registered.
+     */
+    bool add( NameId client);
+
+    /**
+     * @brief: unregister the client.
+     * @param events: set to the ids of the events the client sent a RSVP to.
+     * @return: false if the client is not registered.
+     */
+    bool remove( NameId client, std::vector<int>& events);
+
+    /**
+     * @brief: index that the client sent a RSVP to the event.
+     * @return: false if the client is not registered (anymore).
+     */
+    bool addEvent( NameId client, int eventId);
+
+    /**
+     * @return: true if the client is registered.
+     */
+    bool contains( NameId client);
+
+    /**
+     * @brief: unregister all the clients.
+     */
+    void clear();
+
+private:
+
+    struct Shard
+    {
+        RWLock lock;
+        /* client -> ids of the events it sent a RSVP to */
+        std::map<NameId, std::vector<int> > clients;
+    };
+
+    Shard _shards[NUM_CLIENT_SHARDS];
+
+    /**
+     * @return: the shard of the client.
+     */
+    Shard& _shardOf( NameId client) {
+        return _shards[client & (NUM_CLIENT_SHARDS - 1)];
+    }
+};
+
+#endif /* CLIENTREGISTRY_H_ */
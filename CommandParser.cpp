@@ -7,85 +7,131 @@
 #include "CommandParser.h"
 
 /**
- * @return: the command type according to the Commands enum.
+ * @return: the (upper case) name of the command type.
  */
-int CommandParser::getCommandType( std::string command)
+const std::string& CommandParser::commandName( int commandType)
 {
-    commandsMap commTypesMap = {
-                    { "REGISTER" , 0},
-                    { "CREATE" , 1},
-                    { "UNREGISTER" , 2},
-                    { "EXIT" , 3},
-                    { "SEND_RSVP" , 4},
-                    { "GET_RSVPS_LIST" , 5},
-                    { "GET_TOP_5" , 6},
-                    { "ILLEGAL", 7}
+    /* in the order of the Commands enum */
+    static const std::string names[NUM_COMMANDS] = {
+                    "REGISTER",
+                    "CREATE",
+                    "UNREGISTER",
+                    "EXIT",
+                    "SEND_RSVP",
+                    "GET_RSVPS_LIST",
+                    "GET_TOP_5",
+                    "ILLEGAL",
+                    "GET_TOP"
                   };
 
-    if ( commTypesMap.find( command) != commTypesMap.end() ) {
-        return commTypesMap[command];
+    if ( commandType < 0 || commandType >= NUM_COMMANDS) {
+        return names[ILLEGAL];
     }
-    return commTypesMap["ILLEGAL"];
+    return names[commandType];
 }
 
 
 /**
- * @brief: function splitsline into tokens vector by sep separator.
+ * @return: the command type according to the Commands enum - the command
+ * is matched ignoring case, without an upper case copy of it.
+ */
+int CommandParser::getCommandType( StrRef command)
+{
+    int type;
+
+    for ( type = 0; type < NUM_COMMANDS; ++type) {
+        const std::string& name = commandName( type);
+
+        if ( name.size() == command.size &&
+             strncasecmp( name.data(), command.data, command.size) == EQUAL) {
+            return type;
+        }
+    }
+    return ILLEGAL;
+}
+
+
+/**
+ * @brief: function splits line into slices of it by sep separator - the
+ * line ends at a new line and empty tokens are skipped. tokens after the
+ * first maxTokens are ignored. nothing is copied or allocated.
  * @param line: the command line to split into tokens.
  * @param sep: separator- usually a space char.
- * @param tokens: empty vector of strings - to store tokens result.
+ * @param tokens: array of maxTokens slices - to store tokens result.
+ * @return: number of tokens.
  */
-void CommandParser::tokenize( const std::string &line, const std::string sep,
-                              std::vector<std::string> &tokens)
+size_t CommandParser::tokenize( StrRef line, char sep, StrRef* tokens,
+                                size_t maxTokens)
 {
-    std::size_t start = 0, end = 0, hasNewLine = 0;
-    std::string temp;
+    const char* pos = line.data;
+    const char* end = (const char*) memchr( line.data, '\n', line.size);
+    const char* start;
+    size_t count = 0;
 
-    while ((end = line.find(sep, start)) != std::string::npos)
+    if ( end == NULL) {
+        end = line.data + line.size;
+    }
+
+    while ( count < maxTokens)
     {
-        temp = line.substr( start, end - start);
-        if (temp != "") {
-            hasNewLine = temp.find("\n");
-            if (hasNewLine != std::string::npos){
-                temp = temp.substr( 0, hasNewLine);
-            }
-            tokens.push_back(temp);
+        while ( pos < end && *pos == sep) {
+            ++pos;
+        }
+        if ( pos == end) {
+            break;
+        }
+
+        start = pos;
+        while ( pos < end && *pos != sep) {
+            ++pos;
         }
-        start = end + 1;
+        tokens[count++] = StrRef( start, pos - start);
     }
+    return count;
+}
+
+
+/**
+ * @return: the slice of line from token (a token of it) to the end of the
+ * line - at a new line - without trailing separators, so the CREATE
+ * description keeps its spaces, as typed.
+ */
+StrRef CommandParser::restOfLine( StrRef line, StrRef token, char sep)
+{
+    const char* end = (const char*) memchr( token.data, '\n',
+                                            line.data + line.size -
+                                            token.data);
 
-    temp = line.substr(start);
-    if (temp != "") tokens.push_back(temp);
+    if ( end == NULL) {
+        end = line.data + line.size;
+    }
+    while ( end > token.data + token.size && *(end - 1) == sep) {
+        --end;
+    }
+    return StrRef( token.data, end - token.data);
 }
 
 
 /**
- * @brief: function joins string tokens from tokens vector from idx index
- * with sep separator into one string instead of the previous tokens.
- * @param tokens: vector of string tokens - to get tokens to join.
- * @param sep: separator- usually a space char.
- * @param idx: index from where to join tokens.
+ * @brief: convert a string of digits to a number.
+ * @return: false if s is not numeric or does not fit an int.
  */
-void CommandParser::joinTokens( std::vector<std::string>& tokens,
-                                const std::string sep, int idx)
+bool CommandParser::toNumber( StrRef s, int& value)
 {
-    std::string description;
-    std::stringstream stream;
-    std::vector<std::string>::iterator it;
-
-    if ( tokens.size() >= 4) {
-        it = tokens.begin() + idx;
-        while ( it != tokens.end()) {
-          stream << *it;
-          stream << sep;
-          // delete current token and advance to next
-          tokens.erase(it);
-        }
+    long long number = 0;
+    size_t i;
 
-        description = stream.str();
-        description.erase( description.size() - 1);
-        tokens.push_back( description);
+    if ( !isStrNumber( s)) {
+        return false;
     }
+    for ( i = 0; i < s.size; ++i) {
+        number = number * 10 + (s.data[i] - '0');
+        if ( number > INT_MAX) {
+            return false;
+        }
+    }
+    value = (int) number;
+    return true;
 }
 
 
@@ -119,11 +165,11 @@ bool CommandParser::isNumeric( const char *str)
 /**
  * @return: true if string represents number.
  */
-bool CommandParser::isStrNumber(const std::string& s)
+bool CommandParser::isStrNumber( StrRef s)
 {
-    std::string::const_iterator it = s.begin();
-    while (it != s.end() && std::isdigit(*it)) ++it;
-    return !s.empty() && it == s.end();
+    size_t i = 0;
+    while (i < s.size && isdigit( (unsigned char) s.data[i])) ++i;
+    return !s.empty() && i == s.size;
 }
 
 
@@ -132,43 +178,52 @@ bool CommandParser::isStrNumber(const std::string& s)
  * @return: true is strings are equal in not sensitive case
  * comparison.
  */
-bool CommandParser::compare_nocase( const std::string& first,
-                                    const std::string& second)
+bool CommandParser::compare_nocase( StrRef first, StrRef second)
 {
   unsigned int i=0;
-  while (( i < first.length()) && ( i < second.length()) )
+  while (( i < first.size) && ( i < second.size) )
   {
-    if ( tolower( first[i]) < tolower( second[i])) return true;
-    else if ( tolower( first[i]) > tolower( second[i])) return false;
+    if ( tolower( first.data[i]) < tolower( second.data[i])) return true;
+    else if ( tolower( first.data[i]) > tolower( second.data[i])) return false;
     ++i;
   }
-  return ( first.length() < second.length() );
+  return ( first.size < second.size );
 }
 
 
 /**
- * @brief: converts the given list of strings into one string, while
- * the string tokens will be separated by sepatator string sep.
- * @return: string of the tokens in the list.
+ * @brief: checks if line is a session opening line and if so
+ * extracts the client name from it.
+ * @return: true if line is SESSION <client name>.
  */
-std::string CommandParser::convertListToString( std::list<std::string> list, const std::string sep)
+bool CommandParser::isSessionRequest( const std::string& line,
+                                      std::string& client)
 {
-    std::string listStr;
-    std::list<std::string>::iterator it;
+    if ( line.compare( 0, SESSION_COMMAND.size(), SESSION_COMMAND) != EQUAL) {
+        return false;
+    }
+    client = line.substr( SESSION_COMMAND.size());
+    return true;
+}
 
-    /* first sort list by names */
-    list.sort( CommandParser::compare_nocase);
 
-    /* append each guest name to string list */
-    for (it = list.begin(); it != list.end(); ++it) {
-        listStr += *it + sep;
+/**
+ * @brief: checks if line is a binary session opening line and if so
+ * extracts the client name from it.
+ * @return: true if line is BINARY <client name>.
+ */
+bool CommandParser::isBinarySessionRequest( const std::string& line,
+                                            std::string& client)
+{
+    if ( line.compare( 0, BINARY_SESSION_COMMAND.size(),
+                       BINARY_SESSION_COMMAND) != EQUAL) {
+        return false;
     }
-
-    /* remove last comma char */
-    listStr.erase( listStr.size() - 1);
-    return listStr;
+    client = line.substr( BINARY_SESSION_COMMAND.size());
+    return true;
 }
 
+
 std::string CommandParser::logCommandError( const std::string clientName,
                                             CommandResult errType,
                                             const std::string command,
@@ -14,6 +14,7 @@
 #include <fstream>   // std::fstream
 #include <string>
 #include <string.h>
+#include <strings.h> // strncasecmp
 #include <sys/types.h> // for size_t, off_t
 #include <vector>
 #include <map>
@@ -21,22 +22,42 @@
 #include <iostream>     // std::cout
 #include <sstream>      // std::stringstream, std::stringbuf
 #include <algorithm> // sort,distance, find_if, copy_if, transform
+#include <climits> // INT_MAX
+
+#include "StrRef.h"
 
 #define EQUAL 0
+/* max slices of a command line - the command and its arguments, more
+ * arguments are ignored */
+#define MAX_COMMAND_TOKENS 4
+/* default and max number of names in one page of GET_RSVPS_LIST */
+#define DEFAULT_LIST_LIMIT 100
+#define MAX_LIST_LIMIT 10000
+/* max bytes of names in one page - a page has at least one name */
+#define MAX_LIST_PAGE_LEN (64 * 1024)
 /* LIMIT of chars of event command on client side - check it's valid command*/
 #define MAX_TITLE 30
 #define MAX_DATE 30
 #define MAX_DESC 256
-#define EQUAL 0
 
 const std::string NOT_REGISTERED = "ERROR: first command must be REGISTER.";
 const std::string ILLEGAL_COMMAND = "ERROR: illegal command.";
 const std::string EXIT_COMMAND = "EXIT";
+const std::string STATS_COMMAND = "STATS";
+/* first line of a persistent connection: SESSION <client name> */
+const std::string SESSION_COMMAND = "SESSION ";
+/* first line of a binary protocol session: BINARY <client name> */
+const std::string BINARY_SESSION_COMMAND = "BINARY ";
 const std::string ALREADY_REGISTERED = " is already exists.";
 const std::string CLIENT_REGISTERED = " was already registered.";
 const std::string REGISTER_SUCCESS = " was registered successfully.";
+const std::string SERVER_FULL = " was not registered: the server is full.";
+const std::string NAME_RESERVED = " was not registered: the name is reserved.";
 const std::string EVENT_NOT_EXIST = "event does not exist.";
 const std::string ERROR_EVENT_ALLOC = "ERROR: cannot allocate new event.";
+/* cursor of the first page of GET_RSVPS_LIST <id> <cursor> [limit] - no
+ * client can register with this name, so it is never the cursor of a page */
+const std::string LIST_CURSOR_START = "-";
 
 
 enum Commands
@@ -48,7 +69,34 @@ enum Commands
     SEND_RSVP = 4,
     GET_RSVPS_LIST = 5,
     GET_TOP_5 = 6,
-    ILLEGAL = 7
+    ILLEGAL = 7,
+    GET_TOP = 8, /* GET_TOP <n> - the n newest events */
+    NUM_COMMANDS = 9
+};
+
+/* status code of a command response - sent in binary response frames */
+enum ResponseStatus
+{
+    STATUS_OK = 0,
+    STATUS_ERROR = 1,
+    STATUS_NOT_REGISTERED = 2,
+    STATUS_ALREADY = 3, /* already registered or RSVP already sent */
+    STATUS_FULL = 4 /* no room for the name of a new client */
+};
+
+/* the parsed arguments of a command - the strings are slices of the command
+ * line (or request frame) they were parsed from, valid while it is */
+struct CommandArgs
+{
+    int eventId;
+    int count; /* GET_TOP */
+    StrRef title;
+    StrRef date;
+    StrRef description;
+    StrRef cursor; /* GET_RSVPS_LIST page, empty for the whole list */
+    int limit; /* GET_RSVPS_LIST page */
+
+    CommandArgs(): eventId( 0), count( 0), limit( 0) {}
 };
 
 enum CommandResult
@@ -63,36 +111,45 @@ enum CommandResult
 
 class CommandParser
 {
-        typedef std::map<std::string, int> commandsMap;
-
     public:
 
 
         /**
-         * @return: the command type according to the Commands enum.
+         * @return: the command type according to the Commands enum - the
+         * command is matched ignoring case.
          */
-        static int getCommandType( std::string command);
+        static int getCommandType( StrRef command);
+
+        /**
+         * @return: the (upper case) name of the command type.
+         */
+        static const std::string& commandName( int commandType);
 
 
         /**
-         * @brief: function splitsline into tokens vector by sep separator.
+         * @brief: function splits line into slices of it by sep separator -
+         * the line ends at a new line, tokens after the first maxTokens are
+         * ignored. nothing is copied or allocated.
          * @param line: the command line to split into tokens.
          * @param sep: separator- usually a space char.
-         * @param tokens: empty vector of strings - to store tokens result.
+         * @param tokens: array of maxTokens slices - to store tokens result.
+         * @return: number of tokens.
          */
-        static void tokenize( const std::string &line, const std::string sep,
-                              std::vector<std::string> &tokens);
+        static size_t tokenize( StrRef line, char sep, StrRef* tokens,
+                                size_t maxTokens);
 
+        /**
+         * @return: the slice of line from token (a token of it) to the end
+         * of the line, without trailing separators - the CREATE description,
+         * as typed.
+         */
+        static StrRef restOfLine( StrRef line, StrRef token, char sep);
 
         /**
-         * @brief: function joins string tokens from tokens vector from index
-         * with sep separator into one string instead of the previous tokens.
-         * @param tokens: vector of string tokens - to get tokens to join.
-         * @param sep: separator- usually a space char.
-         * @param idx: index from where to join tokens.
+         * @brief: convert a string of digits to a number.
+         * @return: false if s is not numeric or does not fit an int.
          */
-        static void joinTokens( std::vector<std::string>& tokens,
-                                const std::string sep, int idx);
+        static bool toNumber( StrRef s, int& value);
 
         /**
          * @bried: Check whether the given string represent a valid number.
@@ -105,7 +162,7 @@ class CommandParser
         /**
          * @return: true if string represents number.
          */
-        static bool isStrNumber( const std::string& s);
+        static bool isStrNumber( StrRef s);
 
 
         /**
@@ -113,17 +170,24 @@ class CommandParser
          * @return: true is strings are equal in not sensitive case
          * comparison.
          */
-        static bool compare_nocase( const std::string& first,
-                                    const std::string& second);
+        static bool compare_nocase( StrRef first, StrRef second);
+
 
         /**
-         * @brief: converts the given list of strings into one string, while
-         * the string tokens will be separated by sepatator string sep.
-         * @return: string of the tokens in the list.
+         * @brief: checks if line is a session opening line and if so
+         * extracts the client name from it.
+         * @return: true if line is SESSION <client name>.
          */
-        static std::string convertListToString( std::list<std::string> list,
-                                                const std::string sep);
+        static bool isSessionRequest( const std::string& line,
+                                      std::string& client);
 
+        /**
+         * @brief: checks if line is a binary session opening line and if so
+         * extracts the client name from it.
+         * @return: true if line is BINARY <client name>.
+         */
+        static bool isBinarySessionRequest( const std::string& line,
+                                            std::string& client);
 
         static std::string logCommandError( const std::string clientName,
                                             CommandResult errType,
@@ -0,0 +1,113 @@
+/*
+ * CommandSequencer.cpp
+ * Created on: Oct 17, 2026
+ * Author: nicole
+ */
+
+#include "CommandSequencer.h"
+
+/**
+ * @brief: Constructor - starts the writer thread.
+ */
+CommandSequencer::CommandSequencer( BatchApplier applier): _apply( applier),
+        _head( nullptr), _stop( false), _batches( 0), _applied( 0),
+        _writer( &CommandSequencer::_writerLoop, this)
+{}
+
+
+/**
+ * destructor - applies the commands left and joins the writer thread.
+ */
+CommandSequencer::~CommandSequencer()
+{
+    {
+        std::lock_guard<std::mutex> guard( _lock);
+        _stop = true;
+    }
+    _wakeCond.notify_one();
+    _writer.join();
+}
+
+
+/**
+ * @brief: submit the command to the writer and wait until it is applied -
+ * its response and status are set in mutation. the push is a lock free
+ * compare and swap, only the push into an empty queue wakes the writer.
+ */
+void CommandSequencer::run( Mutation& mutation)
+{
+    mutation.next = _head.load( std::memory_order_relaxed);
+    while ( !_head.compare_exchange_weak( mutation.next, &mutation,
+                                          std::memory_order_release,
+                                          std::memory_order_relaxed)) {}
+
+    if ( mutation.next == nullptr) {
+        /* under the lock, so the wake can not slip in between the writer
+         * check of the queue and its wait */
+        std::lock_guard<std::mutex> guard( _lock);
+        _wakeCond.notify_one();
+    }
+
+    std::unique_lock<std::mutex> lock( mutation.doneLock);
+    mutation.doneCond.wait( lock, [&mutation] { return mutation.done; });
+}
+
+
+/**
+ * @return: "batches <n> commands <n>" - how the writes were grouped.
+ */
+std::string CommandSequencer::stats()
+{
+    return "batches " + std::to_string( _batches.load()) + " commands " +
+           std::to_string( _applied.load());
+}
+
+/*************** Private Functions **************************************/
+
+/**
+ * @brief: the writer thread - take all the submitted commands at once,
+ * apply them as one batch in submission order and wake each of their
+ * submitters.
+ * stops once stopped and the queue is empty.
+ */
+void CommandSequencer::_writerLoop()
+{
+    std::vector<Mutation*> batch;
+    std::vector<Mutation*>::iterator it;
+    Mutation* mutation;
+
+    while ( true)
+    {
+        mutation = _head.exchange( nullptr, std::memory_order_acquire);
+        if ( mutation == nullptr) {
+            std::unique_lock<std::mutex> lock( _lock);
+            if ( _stop) {
+                break;
+            }
+            _wakeCond.wait( lock, [this] {
+                return _stop || _head.load( std::memory_order_relaxed) !=
+                                nullptr;
+            });
+            continue;
+        }
+
+        /* the queue is newest first */
+        batch.clear();
+        for ( ; mutation != nullptr; mutation = mutation->next) {
+            batch.push_back( mutation);
+        }
+        std::reverse( batch.begin(), batch.end());
+
+        _apply( batch);
+        _batches++;
+        _applied += batch.size();
+
+        for ( it = batch.begin(); it != batch.end(); ++it) {
+            /* notified under the lock - once it is released the submitter
+             * may return and the mutation is gone */
+            std::lock_guard<std::mutex> guard( (*it)->doneLock);
+            (*it)->done = true;
+            (*it)->doneCond.notify_one();
+        }
+    }
+}
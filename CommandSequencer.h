@@ -0,0 +1,105 @@
+/*
+ * CommandSequencer.h
+ * Created on: Oct 17, 2026
+ * Author: nicole
+ */
+
+#ifndef COMMANDSEQUENCER_H_
+#define COMMANDSEQUENCER_H_
+
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <algorithm> // reverse
+
+#include "CommandParser.h"
+
+
+/**
+ * a mutating command waiting for the writer thread. it lives on the stack
+ * of the submitting thread until the writer marks it done, and has its own
+ * lock and condition, so the writer wakes exactly the submitters of its
+ * batch.
+ */
+struct Mutation
+{
+    std::string client;
+    int commType;
+    CommandArgs args;
+    std::string response; /* set by the writer */
+    int status;           /* set by the writer */
+    bool done;            /* guarded by doneLock */
+    Mutation* next;       /* link in the submit queue */
+    std::mutex doneLock;
+    std::condition_variable doneCond; /* the submitter waits for done */
+
+    Mutation( const std::string& clientName, int type,
+              const CommandArgs& commArgs): client( clientName),
+            commType( type), args( commArgs), status( STATUS_ERROR),
+            done( false), next( nullptr)
+    {}
+};
+
+
+/**
+ * A single writer for the mutating commands. Any number of threads submit
+ * commands to a lock free multi producer queue, one writer thread takes all
+ * the submitted commands at once and applies them as a batch, in
+ * submission order, then wakes the submitters. writes never contend with
+ * each other, their order is deterministic and work done per write (like
+ * logging) can be done once per batch.
+ */
+class CommandSequencer
+{
+public:
+
+    /* applies a batch of commands, in order, setting their results */
+    typedef std::function<void( std::vector<Mutation*>& batch)> BatchApplier;
+
+    /**
+     * @brief: Constructor - starts the writer thread.
+     */
+    CommandSequencer( BatchApplier applier);
+
+    /**
+     * destructor - applies the commands left and joins the writer thread.
+     */
+    virtual ~CommandSequencer();
+
+    CommandSequencer( CommandSequencer const &other) = delete;
+    void operator=( CommandSequencer const &other) = delete;
+
+    /**
+     * @brief: submit the command to the writer and wait until it is
+     * applied - its response and status are set in mutation.
+     */
+    void run( Mutation& mutation);
+
+    /**
+     * @return: "batches <n> commands <n>" - how the writes were grouped.
+     */
+    std::string stats();
+
+private:
+
+    BatchApplier _apply;
+    std::atomic<Mutation*> _head; /* submitted, newest first */
+    std::mutex _lock;
+    std::condition_variable _wakeCond; /* the writer waits for commands */
+    bool _stop;
+    std::atomic<size_t> _batches;
+    std::atomic<size_t> _applied;
+    std::thread _writer;
+
+    /**
+     * @brief: the writer thread - apply the submitted commands in batches
+     * until stopped.
+     */
+    void _writerLoop();
+};
+
+#endif /* COMMANDSEQUENCER_H_ */
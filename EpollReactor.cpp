@@ -0,0 +1,264 @@
+/*
+ * EpollReactor.cpp
+ * Created on: Oct 17, 2026
+ * Author: nicole
+ */
+
+#include "EpollReactor.h"
+
+/**
+ * @brief: set the given file descriptor to non-blocking mode.
+ * @return: fcntl result, negative on error.
+ */
+static int setNonBlocking( int fd)
+{
+    int flags = fcntl( fd, F_GETFL, 0);
+    if ( flags < 0) {
+        return flags;
+    }
+    return fcntl( fd, F_SETFL, flags | O_NONBLOCK);
+}
+
+/*************** Public Functions **************************************/
+
+/**
+ * @brief: Constructor - takes the (already listening) master socket and
+ * the pool that executes the commands.
+ */
+EpollReactor::EpollReactor( int listenSock, ThreadPool* pool):
+        Reactor( listenSock, pool), _epollFD( -1)
+{}
+
+
+/**
+ * destructor - closes the epoll instance.
+ */
+EpollReactor::~EpollReactor()
+{
+    if ( _epollFD >= 0) {
+        close( _epollFD);
+    }
+}
+
+
+/**
+ * @brief: create the epoll instance and register the master socket and
+ * the wake eventfd.
+ * @return: false if epoll can not be used.
+ */
+bool EpollReactor::init()
+{
+    _epollFD = epoll_create1( 0);
+    if ( _epollFD < 0) {
+        Server::logServerError( "epoll_create1", std::to_string( errno));
+        return false;
+    }
+
+    setNonBlocking( _listenSock);
+    _addFD( _listenSock, EPOLLIN | EPOLLET);
+
+    if ( _wakeFD >= 0) {
+        _addFD( _wakeFD, EPOLLIN | EPOLLET);
+    }
+    return true;
+}
+
+
+/**
+ * @brief: run the event loop until stop is called.
+ */
+void EpollReactor::run()
+{
+    struct epoll_event events[MAX_EPOLL_EVENTS];
+    int numReady, i, fd;
+    uint64_t count;
+    std::map<int, Connection*>::iterator it;
+
+    if ( _epollFD < 0) {
+        return;
+    }
+
+    while ( _running)
+    {
+        numReady = epoll_wait( _epollFD, events, MAX_EPOLL_EVENTS, -1);
+        if ( numReady < 0) {
+            if ( errno == EINTR) {
+                continue;
+            }
+            Server::logServerError( "epoll_wait", std::to_string( errno));
+            break;
+        }
+
+        for ( i = 0; i < numReady; ++i)
+        {
+            fd = events[i].data.fd;
+
+            if ( fd == _listenSock) {
+                _acceptConnections();
+                continue;
+            }
+
+            if ( fd == _wakeFD) {
+                /* reset the eventfd counter - edge triggered */
+                while ( read( _wakeFD, &count, sizeof(count)) > 0) {}
+                _collectResponses();
+                continue;
+            }
+
+            it = _connections.find( fd);
+            if ( it == _connections.end()) {
+                continue;
+            }
+
+            if ( events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) {
+                _readConnection( it->second);
+                /* connection may be closed while reading */
+                it = _connections.find( fd);
+                if ( it == _connections.end()) {
+                    continue;
+                }
+            }
+
+            if ( events[i].events & EPOLLOUT) {
+                _writeConnection( it->second);
+            }
+        }
+
+        _resumeDrained();
+    }
+}
+
+/*************** Protected Functions **************************************/
+
+/**
+ * @brief: write as much of the pending response as the socket accepts.
+ */
+void EpollReactor::_writeConnection( Connection* conn)
+{
+    while ( !conn->out.empty())
+    {
+        /* many queued responses (header and payload) in one call */
+        if ( conn->out.writeTo( conn->sock) < 0) {
+            if ( errno == EINTR) {
+                continue;
+            }
+            if ( errno == EAGAIN || errno == EWOULDBLOCK) {
+                return; /* wait for EPOLLOUT */
+            }
+            _closeConnection( conn);
+            return;
+        }
+    }
+
+    _writeDone( conn); /* may close the connection */
+}
+
+
+/**
+ * @brief: unregister the client socket from epoll.
+ */
+void EpollReactor::_detachConnection( Connection* conn)
+{
+    epoll_ctl( _epollFD, EPOLL_CTL_DEL, conn->sock, NULL);
+}
+
+
+/**
+ * @brief: read what the paused connection left in the socket - edge
+ * triggered, no new EPOLLIN comes for the bytes that were already there.
+ */
+void EpollReactor::_resumeInput( Connection* conn)
+{
+    _readConnection( conn);
+}
+
+/*************** Private Functions **************************************/
+
+/**
+ * @brief: register fd in epoll instance with the given events mask.
+ */
+void EpollReactor::_addFD( int fd, uint32_t events)
+{
+    struct epoll_event ev;
+    memset( &ev, 0, sizeof(ev));
+    ev.events = events;
+    ev.data.fd = fd;
+
+    if ( epoll_ctl( _epollFD, EPOLL_CTL_ADD, fd, &ev) < 0) {
+        Server::logServerError( "epoll_ctl", std::to_string( errno));
+    }
+}
+
+
+/**
+ * @brief: accept all pending connections on the master socket.
+ */
+void EpollReactor::_acceptConnections()
+{
+    int newSockFD;
+
+    /* edge triggered - accept until there are no more pending connections */
+    while ( true)
+    {
+        newSockFD = accept( _listenSock, NULL, NULL);
+        if ( newSockFD < 0) {
+            if ( errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                Server::logServerError( "accept", std::to_string( errno));
+            }
+            if ( errno == EINTR) {
+                continue;
+            }
+            return;
+        }
+
+        setNonBlocking( newSockFD);
+        _addConnection( newSockFD);
+        _addFD( newSockFD, EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET);
+    }
+}
+
+
+/**
+ * @brief: read all available bytes from the client socket and handle the
+ * requests that were completely received. a backlogged connection is
+ * paused - the bytes are left in the socket until it is resumed.
+ */
+void EpollReactor::_readConnection( Connection* conn)
+{
+    ssize_t numRead;
+
+    if ( conn->paused) {
+        return;
+    }
+
+    while ( true)
+    {
+        if ( _backlogged( conn)) {
+            _pause( conn);
+            break;
+        }
+
+        numRead = conn->reader.fill( conn->sock);
+        if ( numRead > 0) {
+            /* binary frames are checked by their length header */
+            if ( !conn->binary && conn->reader.overflow()) {
+                Server::logServerError( "read", "request line is too long");
+                _closeConnection( conn);
+                return;
+            }
+            continue;
+        }
+
+        if ( numRead == 0) {
+            conn->peerClosed = true;
+        } else if ( errno == EINTR) {
+            continue;
+        } else if ( errno != EAGAIN && errno != EWOULDBLOCK) {
+            _closeConnection( conn);
+            return;
+        }
+        break;
+    }
+
+    _inputReceived( conn); /* may close the connection */
+}
@@ -0,0 +1,89 @@
+/*
+ * EpollReactor.h
+ * Created on: Oct 17, 2026
+ * Author: nicole
+ */
+
+#ifndef EPOLLREACTOR_H_
+#define EPOLLREACTOR_H_
+
+#include <sys/epoll.h>
+
+#include "Reactor.h"
+
+/* max number of ready events fetched by one epoll_wait call */
+#define MAX_EPOLL_EVENTS 256
+
+
+/**
+ * An edge-triggered epoll event loop over non-blocking client sockets.
+ * each socket is read until EAGAIN (or until its backlog pauses it) and
+ * written as far as it accepts, the rest of the response is written on
+ * EPOLLOUT.
+ */
+class EpollReactor: public Reactor
+{
+public:
+
+    /**
+     * @brief: Constructor - takes the (already listening) master socket and
+     * the pool that executes the commands.
+     */
+    EpollReactor( int listenSock, ThreadPool* pool);
+
+    /**
+     * destructor - closes the epoll instance.
+     */
+    virtual ~EpollReactor();
+
+    /**
+     * @brief: create the epoll instance and register the master socket and
+     * the wake eventfd.
+     * @return: false if epoll can not be used.
+     */
+    virtual bool init();
+
+    /**
+     * @brief: run the event loop until stop is called.
+     */
+    virtual void run();
+
+protected:
+
+    /**
+     * @brief: write as much of the pending response as the socket accepts.
+     */
+    virtual void _writeConnection( Connection* conn);
+
+    /**
+     * @brief: unregister the client socket from epoll.
+     */
+    virtual void _detachConnection( Connection* conn);
+
+    /**
+     * @brief: read what the paused connection left in the socket.
+     */
+    virtual void _resumeInput( Connection* conn);
+
+private:
+
+    int _epollFD;
+
+    /**
+     * @brief: register fd in epoll instance with the given events mask.
+     */
+    void _addFD( int fd, uint32_t events);
+
+    /**
+     * @brief: accept all pending connections on the master socket.
+     */
+    void _acceptConnections();
+
+    /**
+     * @brief: read all available bytes from the client socket and handle the
+     * requests that were completely received.
+     */
+    void _readConnection( Connection* conn);
+};
+
+#endif /* EPOLLREACTOR_H_ */
@@ -6,95 +6,289 @@
 
 #include "Event.h"
 
-Event::Event( const std::string creator, int ID, const std::string title,
-              const std::string date, const std::string description):
-        _creator( creator), _eventId( ID), _title( title), _date( date),
-        _description( description)
+/**
+ * @brief: Constructor - copies the creator and the toString line of the
+ * event into arena. names are the names of the guest ids.
+ * @throw: std::bad_alloc if the arena can not grow.
+ */
+Event::Event( EventArena& arena, const NameTable& names,
+              StrRef creator, int ID, StrRef title, StrRef date,
+              StrRef description):
+        _eventId( ID), _guests( names), _guestsVersion( 0), _counted( 0)
+{
+    _init( arena, creator, title, date, description);
+}
+
+
+/**
+ * @brief: Constructor - restores the event serialized to record: the
+ * event id, then the creator, title, date and description (each a length
+ * and its bytes), then the count of guests and their ids.
+ * @throw: std::bad_alloc if the arena can not grow.
+ */
+Event::Event( EventArena& arena, const NameTable& names,
+              const std::string& record):
+        _eventId( 0), _guests( names), _guestsVersion( 0), _counted( 0)
 {
-    // TODO Auto-generated constructor stub
+    std::string creator, title, date, description;
+    std::vector<NameId> guests;
+    uint32_t count;
+    size_t pos = 0;
+
+    _eventId = (int) _readU32( record, pos);
+    _readField( record, pos, creator);
+    _readField( record, pos, title);
+    _readField( record, pos, date);
+    _readField( record, pos, description);
+    count = _readU32( record, pos);
+    if ( pos < record.size()) {
+        guests.resize( std::min( (size_t) count,
+                                 (record.size() - pos) / sizeof( NameId)));
+    }
+    if ( !guests.empty()) {
+        memcpy( &guests[0], record.data() + pos,
+                guests.size() * sizeof( NameId));
+    }
 
+    _init( arena, creator, title, date, description);
+    _guests.assign( guests);
 }
 
 Event::~Event()
+{}
+
+/**
+ * @return: true if guest did not send a RSVP to this event yet.
+ */
+bool Event::isNewGuest( NameId guest)
 {
-    RSVP_List.clear();
+    ReadGuard guard( _guestsLock);
+    return !_guests.contains( guest);
 }
 
+
 /**
- * @brief: Convert event data into string in format of:
- * <eventId>\t<eventTitle>\t<eventDate>\t<eventDescription>.\n
- * @return: string event data.
+ * @brief: add guest to the event guests list. only this event is locked.
+ * @param status: STATUS_OK or STATUS_ALREADY if guest already sent
+ * a RSVP to this event.
+ * @return: result of the RSVP.
  */
-std::string Event::toString() const
+std::string Event::registerClient( NameId guest, int& status)
 {
-    std::string eventInfo = "";
-    std::string fileName = std::to_string(_eventId) + '\t' + _title + '\t';
-    eventInfo += _date + '\t' + _description + ".\n";
-    return eventInfo;
+    bool isNew;
+
+    {
+        WriteGuard guard( _guestsLock);
+        /* checked and inserted under one lock - a guest is added once */
+        isNew = _guests.insert( guest);
+        if ( isNew) {
+            _guestsVersion++;
+        }
+    }
+
+    if ( isNew) {
+        status = STATUS_OK;
+        return "SUCCESS";
+    }
+    status = STATUS_ALREADY;
+    return "RSVP to event id " + std::to_string(_eventId) + ALREADY_SENT_RSVP;
 }
 
-bool Event::isNewGuest( const std::string guest)
+
+/**
+ * @return: the guest names, sorted and separated by GUESTS_SEPARATOR -
+ * shared, cached until the guests change. readers of the event run in
+ * parallel, the first one after a change builds the list again.
+ */
+std::shared_ptr<const std::string> Event::getGuestsText()
+{
+    std::shared_ptr<const std::string> text;
+    std::string guests;
+    ReadGuard guard( _guestsLock);
+
+    text = _guestsCache.get( _guestsVersion);
+    if ( text == nullptr) {
+        _guests.appendNames( guests, GUESTS_SEPARATOR);
+        text = _guestsCache.put( _guestsVersion, std::move( guests));
+    }
+    return text;
+}
+
+
+/**
+ * @brief: append a page of the guest names - those after the name after
+ * (from the first if empty), at most limit of them and MAX_LIST_PAGE_LEN
+ * bytes - separated by GUESTS_SEPARATOR, to page. pages are not cached.
+ * @param next: set to the last name of the page if more follow it.
+ */
+void Event::getGuestsPage( StrRef after, size_t limit,
+                           std::string& page, std::string& next)
 {
-    std::set<std::string>::iterator it;
-    std::string guestIn( guest);
-    /* transform first command word to upper case */
-    std::transform( guestIn.begin(), guestIn.end(),guestIn.begin(), ::toupper);
+    ReadGuard guard( _guestsLock);
+    _guests.appendPage( page, GUESTS_SEPARATOR, after, limit,
+                        MAX_LIST_PAGE_LEN, next);
+}
 
-    it = _guestsNames.find( guestIn);
 
-    if ( it != _guestsNames.end()) {
+/**
+ * @brief: remove guest from the event guests list, if there.
+ * @return: true if guest was removed.
+ */
+bool Event::removeGuest( NameId guest)
+{
+    WriteGuard guard( _guestsLock);
+    if ( !_guests.remove( guest)) {
         return false;
     }
+    _guestsVersion++;
     return true;
 }
 
 
-std::string Event::registerClient( const std::string guest)
+/**
+ * @return: the version of the guests - 0 until they change.
+ */
+uint64_t Event::guestsVersion()
 {
-    bool isNew;
-    std::string guestIn( guest);
-    /* transform first command word to upper case */
-    std::transform( guestIn.begin(), guestIn.end(),guestIn.begin(), ::toupper);
+    ReadGuard guard( _guestsLock);
+    return _guestsVersion;
+}
 
-    isNew = isNewGuest( guestIn);
-    std::string response;
 
-    if ( isNew) {
-        _guestsNames.insert( guestIn);
-        RSVP_List.push_back( guestIn);
-        response = "SUCCESS";
-    } else {
-        response = "RSVP to event id " + std::to_string(_eventId) + ALREADY_SENT_RSVP;
-    }
+/**
+ * @brief: append the event with its guests, as a record the restoring
+ * Constructor reads, to record.
+ */
+void Event::serialize( std::string& record)
+{
+    uint32_t count;
+    ReadGuard guard( _guestsLock);
+
+    _appendU32( record, (uint32_t) _eventId);
+    _appendField( record, _creator, _creatorLen);
+    _appendField( record, _text + _titleAt, _titleLen);
+    _appendField( record, _text + _dateAt, _dateLen);
+    _appendField( record, _text + _descriptionAt, _descriptionLen);
+    count = _guests.size();
+    _appendU32( record, count);
+    _guests.appendIds( record);
+}
+
+
+/**
+ * @return: bytes the event holds in the arena, in its guests (with their
+ * spare capacity) and in their cached list.
+ */
+size_t Event::memoryUsage()
+{
+    ReadGuard guard( _guestsLock);
+    return sizeof( Event) + _creatorLen + _textLen +
+           _guests.memoryUsage() + _guestsCache.memoryUsage();
+}
+
+
+/**
+ * @return: the change of memoryUsage since the last call - all of it on
+ * the first call. calls that race may each see a stale usage, but the
+ * swap keeps the sum of the deltas equal to memoryCounted, so what is
+ * added for the event is what is taken off when it leaves memory.
+ */
+ssize_t Event::memoryDelta()
+{
+    size_t usage = memoryUsage();
 
-    return response;
+    return (ssize_t) usage -
+           (ssize_t) _counted.exchange( usage, std::memory_order_relaxed);
 }
 
-std::list<std::string> Event::getGuestList()
+
+/**
+ * @brief: free the text of the event in arena - before it is destroyed,
+ * when it is not freed with the whole arena.
+ */
+void Event::releaseText( EventArena& arena)
 {
-    return RSVP_List;
+    arena.freeText( _creator, _creatorLen);
+    arena.freeText( _text, _textLen);
 }
 
-void Event::removeGuest( const std::string guest)
+/*************** Private Functions **************************************/
+
+/**
+ * @brief: copy the creator and the toString line into arena - the title,
+ * date and description are spans of the line.
+ * @throw: std::bad_alloc if the arena can not grow.
+ */
+void Event::_init( EventArena& arena, StrRef creator, StrRef title,
+                   StrRef date, StrRef description)
 {
-    bool isNew;
-    std::list<std::string>::iterator it;
-    std::string guestIn( guest);
-    /* transform first command word to upper case */
-    std::transform( guestIn.begin(), guestIn.end(),guestIn.begin(), ::toupper);
-
-    isNew = isNewGuest( guestIn);
-
-    if (!isNew) {
-        _guestsNames.erase( guestIn);
-        it = RSVP_List.begin();
-        while ( it != RSVP_List.end()) {
-            if ( (*it).compare( guestIn) == 0) {
-                RSVP_List.erase(it);
-                break;
-            }
-            it++;
-        }
+    std::string text = std::to_string( _eventId) + '\t';
+
+    /* the line is built once, straight from the slices */
+    text.reserve( text.size() + title.size + date.size +
+                  description.size + 4);
+    _titleAt = text.size();
+    _titleLen = title.size;
+    text.append( title.data, title.size) += '\t';
+    _dateAt = text.size();
+    _dateLen = date.size;
+    text.append( date.data, date.size) += '\t';
+    _descriptionAt = text.size();
+    _descriptionLen = description.size;
+    text.append( description.data, description.size) += ".\n";
+
+    _creator = arena.copyText( creator);
+    _creatorLen = creator.size;
+    _text = arena.copyText( text);
+    _textLen = text.size();
+}
+
+
+/**
+ * @brief: append value to record, in host byte order.
+ */
+void Event::_appendU32( std::string& record, uint32_t value)
+{
+    record.append( (const char*) &value, sizeof( value));
+}
+
+
+/**
+ * @brief: append len, then the len bytes of field, to record.
+ */
+void Event::_appendField( std::string& record, const char* field,
+                          uint32_t len)
+{
+    _appendU32( record, len);
+    record.append( field, len);
+}
+
+
+/**
+ * @return: the value at pos of record (0 past its end) - pos is moved
+ * after it.
+ */
+uint32_t Event::_readU32( const std::string& record, size_t& pos)
+{
+    uint32_t value = 0;
+
+    if ( pos + sizeof( value) <= record.size()) {
+        memcpy( &value, record.data() + pos, sizeof( value));
     }
+    pos += sizeof( value);
+    return value;
 }
 
+
+/**
+ * @brief: read the field at pos of record into field - pos is moved after
+ * it.
+ */
+void Event::_readField( const std::string& record, size_t& pos,
+                        std::string& field)
+{
+    uint32_t len = _readU32( record, pos);
+
+    field = pos < record.size() ? record.substr( pos, len) : "";
+    pos += len;
+}
@@ -19,16 +19,44 @@
 #include <set>
 #include <iostream>     // std::cout
 #include <sstream>      // std::stringstream, std::stringbuf
-#include <algorithm> //  transform
+#include <algorithm> //  transform, min
+#include <vector>
+#include <atomic>
 
-#define ALREADY_SENT_RSVP " was already sent."
+#include "CommandParser.h"
+#include "RWLock.h"
+#include "GuestSet.h"
+#include "EventArena.h"
+#include "ResponseCache.h"
 
+#define ALREADY_SENT_RSVP " was already sent."
+/* separator of the guest names in the RSVP list */
+#define GUESTS_SEPARATOR ","
+
+/**
+ * A server event with its guests list. The guests are kept in a GuestSet,
+ * in RSVP order and sorted by name, and guarded by the event's own
+ * reader/writer lock, so RSVPs to different events never contend and
+ * guests lists of one event are read in parallel.
+ * events live in an EventArena: the event is placed in a slab and its
+ * creator and toString line are copied into the arena text - the title,
+ * date and description are spans of that line. a cold event can be
+ * serialized into a record (see EventStore) and restored from it.
+ */
 class Event
 {
     public:
 
-        Event( const std::string creator, int ID, const std::string title,
-               const std::string date, const std::string description);
+        Event( EventArena& arena, const NameTable& names,
+               StrRef creator, int ID, StrRef title, StrRef date,
+               StrRef description);
+
+        /**
+         * @brief: Constructor - restores the event serialized to record.
+         * @throw: std::bad_alloc if the arena can not grow.
+         */
+        Event( EventArena& arena, const NameTable& names,
+               const std::string& record);
 
         virtual ~Event();
 
@@ -37,46 +65,149 @@ class Event
         }
 
         std::string _getEventCreator() {
-            return _creator;
+            return std::string( _creator, _creatorLen);
         }
 
         std::string _getEventTitle() {
-            return _title;
+            return std::string( _text + _titleAt, _titleLen);
         }
 
         std::string _getEventDate() {
-            return _date;
+            return std::string( _text + _dateAt, _dateLen);
         }
 
         std::string _getEventDescription() {
-            return _description;
+            return std::string( _text + _descriptionAt, _descriptionLen);
         }
 
         /**
-         * @brief: Convert event data into string in format of:
+         * @brief: the event data in format of:
          * <eventId>\t<eventTitle>\t<eventDate>\t<eventDescription>.\n
          * @return: string event data.
          */
-        std::string toString() const;
+        std::string toString() const {
+            return std::string( _text, _textLen);
+        }
+
+        /**
+         * @brief: append toString to out, without a copy of its own.
+         */
+        void appendTo( std::string& out) const {
+            out.append( _text, _textLen);
+        }
+
+
+        /**
+         * @return: true if guest did not send a RSVP to this event yet.
+         */
+        bool isNewGuest( NameId guest);
+
+        /**
+         * @brief: add guest to the event guests list.
+         * @param status: STATUS_OK or STATUS_ALREADY if guest already sent
+         * a RSVP to this event.
+         * @return: result of the RSVP.
+         */
+        std::string registerClient( NameId guest, int& status);
+
+        /**
+         * @return: the guest names, sorted and separated by
+         * GUESTS_SEPARATOR - shared, cached until the guests change.
+         */
+        std::shared_ptr<const std::string> getGuestsText();
+
+        /**
+         * @brief: append a page of the guest names - those after the name
+         * after, at most limit of them - to page. see GuestSet::appendPage.
+         */
+        void getGuestsPage( StrRef after, size_t limit,
+                            std::string& page, std::string& next);
+
+        /**
+         * @brief: remove guest from the event guests list, if there.
+         * @return: true if guest was removed.
+         */
+        bool removeGuest( NameId guest);
 
+        /**
+         * @return: the version of the guests - 0 until they change.
+         */
+        uint64_t guestsVersion();
 
-        bool isNewGuest( const std::string guest);
+        /**
+         * @brief: append the event with its guests, as a record the
+         * restoring Constructor reads, to record.
+         */
+        void serialize( std::string& record);
+
+        /**
+         * @return: bytes the event holds in the arena, in its guests and in
+         * their cached list.
+         */
+        size_t memoryUsage();
 
-        std::string registerClient( const std::string guest);
+        /**
+         * @return: the change of memoryUsage since the last call - all of
+         * it on the first call. the deltas add up to memoryCounted.
+         */
+        ssize_t memoryDelta();
 
-        std::list<std::string> getGuestList();
+        /**
+         * @return: the bytes of memoryUsage returned by memoryDelta so far.
+         */
+        size_t memoryCounted() const {
+            return _counted.load( std::memory_order_relaxed);
+        }
 
-        void removeGuest( const std::string guest);
+        /**
+         * @brief: free the text of the event in arena - before it is
+         * destroyed, when it is not freed with the whole arena.
+         */
+        void releaseText( EventArena& arena);
 
     private:
 
-        std::string _creator;
+        const char* _creator; /* in the arena */
+        const char* _text;    /* toString, in the arena - built once */
+        uint32_t _creatorLen;
+        uint32_t _textLen;
         int _eventId;
-        std::string _title;
-        std::string _date;
-        std::string _description;
-        std::set<std::string> _guestsNames;
-        std::list<std::string> RSVP_List;
+        uint32_t _titleAt;    /* offsets and lengths of the fields in _text */
+        uint32_t _titleLen;
+        uint32_t _dateAt;
+        uint32_t _dateLen;
+        uint32_t _descriptionAt;
+        uint32_t _descriptionLen;
+        GuestSet _guests;   /* interned names, by RSVP order and by name */
+        uint64_t _guestsVersion; /* bumped on each change of _guests */
+        ResponseCache _guestsCache; /* the guests list of _guestsVersion */
+        RWLock _guestsLock; /* guards _guests and _guestsVersion */
+        std::atomic<size_t> _counted; /* see memoryCounted */
+
+        /**
+         * @brief: copy the creator and the toString line into arena.
+         */
+        void _init( EventArena& arena, StrRef creator, StrRef title,
+                    StrRef date, StrRef description);
+
+        static void _appendU32( std::string& record, uint32_t value);
+
+        /**
+         * @brief: append len, then the len bytes of field, to record.
+         */
+        static void _appendField( std::string& record, const char* field,
+                                  uint32_t len);
+
+        /**
+         * @return: the value at pos of record - pos is moved after it.
+         */
+        static uint32_t _readU32( const std::string& record, size_t& pos);
+
+        /**
+         * @brief: read the field at pos of record - pos is moved after it.
+         */
+        static void _readField( const std::string& record, size_t& pos,
+                                std::string& field);
 
 };
 
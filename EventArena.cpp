@@ -0,0 +1,179 @@
+/*
+ * EventArena.cpp
+ * Created on: Oct 17, 2026
+ * Author: nicole
+ */
+
+#include "EventArena.h"
+
+EventArena::EventArena(): _slabUsed( 0), _slabSize( 0), _block( nullptr),
+        _blockUsed( 0), _largeBytes( 0)
+{}
+
+
+/**
+ * destructor - releases all the slabs and text blocks.
+ */
+EventArena::~EventArena()
+{
+    clear();
+}
+
+
+/**
+ * @brief: the memory of one event - to construct an Event in place. all
+ * the events have one size, so a slab holds EVENTS_PER_SLAB of them back
+ * to back (new[] memory is aligned for any type, so is each event). a
+ * freed event is reused before the slab grows.
+ * @throw: std::bad_alloc if a new slab can not be allocated.
+ */
+void* EventArena::allocEvent( size_t size)
+{
+    /* round up, so the next event is aligned as well */
+    size_t aligned = (size + alignof( std::max_align_t) - 1) &
+                     ~(alignof( std::max_align_t) - 1);
+    void* event;
+    std::lock_guard<std::mutex> guard( _lock);
+
+    if ( !_freeEvents.empty()) {
+        event = _freeEvents.back();
+        _freeEvents.pop_back();
+        return event;
+    }
+
+    if ( _slabs.empty() || _slabUsed + aligned > _slabSize) {
+        _slabs.reserve( _slabs.size() + 1);
+        _slabs.push_back( new char[aligned * EVENTS_PER_SLAB]);
+        _slabSize = aligned * EVENTS_PER_SLAB;
+        _slabUsed = 0;
+    }
+
+    _slabUsed += aligned;
+    return _slabs.back() + _slabUsed - aligned;
+}
+
+
+/**
+ * @brief: copy text into the arena - at the end of the current block, or
+ * into a new one if it does not fit. each block counts the texts in it.
+ * @return: the copy - valid until clear or freeText.
+ * @throw: std::bad_alloc if a new block can not be allocated.
+ */
+const char* EventArena::copyText( StrRef text)
+{
+    char* copy;
+    std::lock_guard<std::mutex> guard( _lock);
+
+    if ( text.size > TEXT_BLOCK_LEN) {
+        copy = new char[text.size];
+        try {
+            _largeBlocks.insert( copy);
+        } catch ( std::bad_alloc& e) {
+            delete[] copy;
+            throw;
+        }
+        _largeBytes += text.size;
+    } else {
+        if ( _block == nullptr || _blockUsed + text.size > TEXT_BLOCK_LEN) {
+            copy = new char[TEXT_BLOCK_LEN];
+            try {
+                _blocks[copy] = 0;
+            } catch ( std::bad_alloc& e) {
+                delete[] copy;
+                throw;
+            }
+            /* the block left is released when its last text is freed */
+            if ( _block != nullptr && _blocks[_block] == 0) {
+                _blocks.erase( _block);
+                delete[] _block;
+            }
+            _block = copy;
+            _blockUsed = 0;
+        }
+        copy = _block + _blockUsed;
+        _blockUsed += text.size;
+        _blocks[_block]++;
+    }
+
+    memcpy( copy, text.data, text.size);
+    return copy;
+}
+
+
+/**
+ * @brief: free the memory of one destroyed event, for the next event.
+ */
+void EventArena::freeEvent( void* event)
+{
+    std::lock_guard<std::mutex> guard( _lock);
+    _freeEvents.push_back( event);
+}
+
+
+/**
+ * @brief: free a copy of copyText of len bytes - its block is released
+ * when no text is left in it, unless new texts are still copied into it.
+ */
+void EventArena::freeText( const char* text, size_t len)
+{
+    std::map<const char*, size_t>::iterator it;
+    std::lock_guard<std::mutex> guard( _lock);
+
+    if ( len > TEXT_BLOCK_LEN) {
+        _largeBlocks.erase( text);
+        _largeBytes -= len;
+        delete[] text;
+        return;
+    }
+
+    /* the block of text - the last one that starts at or before it */
+    it = _blocks.upper_bound( text);
+    --it;
+    if ( --it->second == 0 && it->first != _block) {
+        delete[] it->first;
+        _blocks.erase( it);
+    }
+}
+
+
+/**
+ * @return: bytes of the slabs and text blocks held.
+ */
+size_t EventArena::bytes()
+{
+    std::lock_guard<std::mutex> guard( _lock);
+    return _slabs.size() * _slabSize + _blocks.size() * TEXT_BLOCK_LEN +
+           _largeBytes;
+}
+
+
+/**
+ * @brief: release all the slabs and text blocks - the events in them
+ * must have been destroyed.
+ */
+void EventArena::clear()
+{
+    std::vector<char*>::iterator it;
+    std::map<const char*, size_t>::iterator blockIt;
+    std::set<const char*>::iterator largeIt;
+    std::lock_guard<std::mutex> guard( _lock);
+
+    for ( it = _slabs.begin(); it != _slabs.end(); ++it) {
+        delete[] *it;
+    }
+    for ( blockIt = _blocks.begin(); blockIt != _blocks.end(); ++blockIt) {
+        delete[] blockIt->first;
+    }
+    for ( largeIt = _largeBlocks.begin(); largeIt != _largeBlocks.end();
+          ++largeIt) {
+        delete[] *largeIt;
+    }
+    _slabs.clear();
+    _freeEvents.clear();
+    _blocks.clear();
+    _largeBlocks.clear();
+    _slabUsed = 0;
+    _block = nullptr;
+    _blockUsed = 0;
+    _largeBytes = 0;
+}
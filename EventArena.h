@@ -0,0 +1,99 @@
+/*
+ * EventArena.h
+ * Created on: Oct 17, 2026
+ * Author: nicole
+ */
+
+#ifndef EVENTARENA_H_
+#define EVENTARENA_H_
+
+#include <string.h> // memcpy
+#include <cstddef> // max_align_t
+#include <string>
+#include <vector>
+#include <map>
+#include <set>
+#include <mutex>
+
+#include "StrRef.h"
+
+/* number of events in one event slab */
+#define EVENTS_PER_SLAB 256
+/* size of one text block - a longer text gets a block of its own */
+#define TEXT_BLOCK_LEN (64 * 1024)
+
+
+/**
+ * A bump pointer arena of the server events and their text. Events are
+ * placed one after the other in slabs of EVENTS_PER_SLAB, and their
+ * strings are copied one after the other into shared text blocks, so
+ * creating an event is two pointer bumps instead of many scattered heap
+ * allocations, and the events of a slab share cache lines and pages.
+ * clear releases everything at once, after the events were destroyed. a
+ * single event can be freed as well (when it is spilled to disk): its
+ * memory is reused by the next event, and a text block is released when
+ * the last text in it is freed.
+ */
+class EventArena
+{
+public:
+
+    EventArena();
+
+    /**
+     * destructor - releases all the slabs and text blocks.
+     */
+    virtual ~EventArena();
+
+    EventArena( EventArena const &other) = delete;
+    void operator=( EventArena const &other) = delete;
+
+    /**
+     * @brief: the memory of one event - to construct an Event in place.
+     * @throw: std::bad_alloc if a new slab can not be allocated.
+     */
+    void* allocEvent( size_t size);
+
+    /**
+     * @brief: copy text into the arena.
+     * @return: the copy - valid until clear.
+     * @throw: std::bad_alloc if a new block can not be allocated.
+     */
+    const char* copyText( StrRef text);
+
+    /**
+     * @brief: free the memory of one destroyed event, for the next event.
+     */
+    void freeEvent( void* event);
+
+    /**
+     * @brief: free a copy of copyText of len bytes.
+     */
+    void freeText( const char* text, size_t len);
+
+    /**
+     * @return: bytes of the slabs and text blocks held.
+     */
+    size_t bytes();
+
+    /**
+     * @brief: release all the slabs and text blocks - the events in them
+     * must have been destroyed.
+     */
+    void clear();
+
+private:
+
+    std::mutex _lock;
+    std::vector<char*> _slabs;  /* event slabs, the last one is in use */
+    size_t _slabUsed;           /* bytes in use in the last slab */
+    size_t _slabSize;           /* bytes of each slab, 0 until the first */
+    std::vector<void*> _freeEvents; /* freed events, reused first */
+    std::map<const char*, size_t> _blocks; /* text block -> texts in it */
+    char* _block;               /* the text block in use */
+    size_t _blockUsed;          /* bytes in use in that block */
+    std::set<const char*> _largeBlocks; /* texts longer than a block */
+    size_t _largeBytes;         /* bytes of those texts */
+};
+
+#endif /* EVENTARENA_H_ */
@@ -0,0 +1,212 @@
+/*
+ * EventSegment.cpp
+ * Created on: Oct 17, 2026
+ * Author: nicole
+ */
+
+#include "EventSegment.h"
+
+EventSegment::EventSegment(): _fd( -1), _end( 0), _free( 0)
+{}
+
+
+/**
+ * destructor - closes the file.
+ */
+EventSegment::~EventSegment()
+{
+    close();
+}
+
+
+/**
+ * @brief: create the file with a unique name and remove the name at once -
+ * the records are freed by the kernel when the file is closed, even if the
+ * server is killed.
+ * @return: false if it can not be created (errno is set).
+ */
+bool EventSegment::open()
+{
+    char name[] = SEGMENT_TEMPLATE;
+
+    close();
+    _fd = mkstemp( name);
+    if ( _fd < 0) {
+        return false;
+    }
+    unlink( name);
+    return true;
+}
+
+
+/**
+ * @brief: write record to the smallest hole it fits in, or the end of the
+ * file - one writer at a time.
+ * @param offset: set to the offset of the record.
+ * @return: false if it was not written.
+ */
+bool EventSegment::append( const std::string& record, uint64_t& offset)
+{
+    uint64_t at;
+    size_t written = 0;
+    ssize_t res;
+
+    if ( _fd < 0) {
+        return false;
+    }
+    at = _allocate( record.size());
+    while ( written < record.size())
+    {
+        res = pwrite( _fd, record.data() + written, record.size() - written,
+                      at + written);
+        if ( res < 0 && errno == EINTR) {
+            continue;
+        }
+        if ( res <= 0) {
+            release( at, record.size());
+            return false;
+        }
+        written += res;
+    }
+
+    offset = at;
+    return true;
+}
+
+
+/**
+ * @brief: release the record of len bytes at offset - it is merged with
+ * the holes next to it, and cut off if it ends the file (else it stays a
+ * hole). one writer at a time.
+ */
+void EventSegment::release( uint64_t offset, uint64_t len)
+{
+    std::map<uint64_t, uint64_t>::iterator next;
+    std::map<uint64_t, uint64_t>::iterator prev;
+    uint64_t end;
+
+    if ( _fd < 0 || len == 0) {
+        return;
+    }
+
+    next = _holes.lower_bound( offset);
+    if ( next != _holes.begin()) {
+        prev = std::prev( next);
+        if ( prev->first + prev->second == offset) {
+            offset = prev->first;
+            len += prev->second;
+            _removeHole( prev);
+        }
+    }
+    if ( next != _holes.end() && offset + len == next->first) {
+        len += next->second;
+        _removeHole( next);
+    }
+
+    end = _end.load( std::memory_order_relaxed);
+    if ( offset + len == end && ftruncate( _fd, offset) == 0) {
+        _end.store( offset, std::memory_order_relaxed);
+        return;
+    }
+    _addHole( offset, len);
+}
+
+
+/**
+ * @brief: read the record of len bytes at offset.
+ * @return: false if it can not be read.
+ */
+bool EventSegment::read( uint64_t offset, uint32_t len,
+                         std::string& record) const
+{
+    size_t done = 0;
+    ssize_t res;
+
+    if ( _fd < 0) {
+        return false;
+    }
+    record.resize( len);
+    while ( done < len)
+    {
+        res = pread( _fd, &record[done], len - done, offset + done);
+        if ( res < 0 && errno == EINTR) {
+            continue;
+        }
+        if ( res <= 0) {
+            return false;
+        }
+        done += res;
+    }
+    return true;
+}
+
+
+/**
+ * @brief: close the file - its records are gone.
+ */
+void EventSegment::close()
+{
+    if ( _fd >= 0) {
+        ::close( _fd);
+        _fd = -1;
+    }
+    _holes.clear();
+    _holesBySize.clear();
+    _end.store( 0, std::memory_order_relaxed);
+    _free.store( 0, std::memory_order_relaxed);
+}
+
+/*************** Private Functions **************************************/
+
+/**
+ * @return: the offset of len bytes taken from the smallest hole they fit
+ * in (the rest of it stays a hole), or from the end of the file.
+ */
+uint64_t EventSegment::_allocate( uint64_t len)
+{
+    std::multimap<uint64_t, uint64_t>::iterator fit;
+    uint64_t offset, holeLen;
+
+    fit = _holesBySize.lower_bound( len);
+    if ( fit == _holesBySize.end()) {
+        offset = _end.load( std::memory_order_relaxed);
+        _end.store( offset + len, std::memory_order_relaxed);
+        return offset;
+    }
+
+    offset = fit->second;
+    holeLen = fit->first;
+    _removeHole( _holes.find( offset));
+    if ( holeLen > len) {
+        _addHole( offset + len, holeLen - len);
+    }
+    return offset;
+}
+
+
+/**
+ * @brief: add the hole of len bytes at offset to the holes.
+ */
+void EventSegment::_addHole( uint64_t offset, uint64_t len)
+{
+    _holes[offset] = len;
+    _holesBySize.insert( std::make_pair( len, offset));
+    _free.fetch_add( len, std::memory_order_relaxed);
+}
+
+
+/**
+ * @brief: remove the hole from the holes.
+ */
+void EventSegment::_removeHole( std::map<uint64_t, uint64_t>::iterator hole)
+{
+    std::multimap<uint64_t, uint64_t>::iterator bySize;
+
+    bySize = _holesBySize.lower_bound( hole->second);
+    while ( bySize->second != hole->first) {
+        ++bySize;
+    }
+    _holesBySize.erase( bySize);
+    _free.fetch_sub( hole->second, std::memory_order_relaxed);
+    _holes.erase( hole);
+}
@@ -0,0 +1,124 @@
+/*
+ * EventSegment.h
+ * Created on: Oct 17, 2026
+ * Author: nicole
+ */
+
+#ifndef EVENTSEGMENT_H_
+#define EVENTSEGMENT_H_
+
+#include <stdint.h>
+#include <stdlib.h> // mkstemp
+#include <unistd.h> // pread, pwrite, unlink, ftruncate
+#include <errno.h>
+#include <string>
+#include <map>
+#include <iterator> // prev
+#include <atomic>
+
+/* name template of the segment file, in the working directory */
+#define SEGMENT_TEMPLATE "emServer.segment.XXXXXX"
+
+
+/**
+ * A file of the records of the events spilled out of memory. A record is
+ * written once and read back by its offset and length - the file is
+ * removed from the directory as soon as it is created, so it lives only as
+ * long as the server. the record of an event that was read back and
+ * changed is released when the event is written again: released records
+ * are kept as holes (adjacent ones merged) and a new record goes to the
+ * smallest hole it fits in, or else at the end of the file. a hole at the
+ * end of the file is cut off.
+ */
+class EventSegment
+{
+public:
+
+    EventSegment();
+
+    /**
+     * destructor - closes the file.
+     */
+    virtual ~EventSegment();
+
+    EventSegment( EventSegment const &other) = delete;
+    void operator=( EventSegment const &other) = delete;
+
+    /**
+     * @brief: create the file.
+     * @return: false if it can not be created (errno is set).
+     */
+    bool open();
+
+    /**
+     * @return: true if the file is open.
+     */
+    bool isOpen() const {
+        return _fd >= 0;
+    }
+
+    /**
+     * @brief: write record to a hole or the end of the file - one writer
+     * at a time.
+     * @param offset: set to the offset of the record.
+     * @return: false if it was not written.
+     */
+    bool append( const std::string& record, uint64_t& offset);
+
+    /**
+     * @brief: release the record of len bytes at offset - its space is
+     * reused. one writer at a time.
+     */
+    void release( uint64_t offset, uint64_t len);
+
+    /**
+     * @brief: read the record of len bytes at offset.
+     * @return: false if it can not be read.
+     */
+    bool read( uint64_t offset, uint32_t len, std::string& record) const;
+
+    /**
+     * @return: bytes of the file.
+     */
+    uint64_t size() const {
+        return _end.load( std::memory_order_relaxed);
+    }
+
+    /**
+     * @return: bytes of the holes in the file.
+     */
+    uint64_t free() const {
+        return _free.load( std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief: close the file - its records are gone.
+     */
+    void close();
+
+private:
+
+    int _fd;
+    std::atomic<uint64_t> _end;  /* end of the file */
+    std::atomic<uint64_t> _free; /* bytes of the holes */
+    std::map<uint64_t /*offset*/, uint64_t /*len*/> _holes;
+    std::multimap<uint64_t /*len*/, uint64_t /*offset*/> _holesBySize;
+
+    /**
+     * @return: the offset of len bytes taken from the smallest hole they
+     * fit in, or from the end of the file.
+     */
+    uint64_t _allocate( uint64_t len);
+
+    /**
+     * @brief: add the hole of len bytes at offset to the holes.
+     */
+    void _addHole( uint64_t offset, uint64_t len);
+
+    /**
+     * @brief: remove the hole at offset from the holes.
+     */
+    void _removeHole( std::map<uint64_t, uint64_t>::iterator hole);
+};
+
+#endif /* EVENTSEGMENT_H_ */
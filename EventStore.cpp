@@ -0,0 +1,610 @@
+/*
+ * EventStore.cpp
+ * Created on: Oct 17, 2026
+ * Author: nicole
+ */
+
+#include "EventStore.h"
+
+/**
+ * @brief: Constructor - names are the names of the guest ids.
+ */
+EventStore::EventStore( const NameTable& names): _names( names), _ids( 1),
+        _newestMax( 0), _ringMask( 0), _claimed( 0), _published( 0),
+        _epoch( 0), _budget( 0), _residentBytes( 0), _clockShard( 0),
+        _retiringWait( false), _spilled( 0), _pagedIn( 0)
+{
+    _newestReaders[0] = 0;
+    _newestReaders[1] = 0;
+    setNewestMax( DEFAULT_NEWEST_MAX);
+}
+
+
+/**
+ * destructor - deletes all the events.
+ */
+EventStore::~EventStore()
+{
+    clear();
+}
+
+
+/**
+ * @brief: create a new event with a new unique event id, taken from the
+ * block of ids of the calling thread. the event is visible by its id before
+ * it is published among the newest events - it is published under the lock
+ * of its shard, so a spill sees its number.
+ * @return: the new event id.
+ * @throw: std::bad_alloc if the event can not be allocated - its slab slot
+ * is released.
+ */
+int EventStore::create( StrRef creator, StrRef title, StrRef date,
+                        StrRef description)
+{
+    int eventId = _ids.next();
+    void* memory = _arena.allocEvent( sizeof( Event));
+    Event* event;
+    Shard& shard = _shardOf( eventId);
+
+    try {
+        event = new ( memory) Event( _arena, _names, creator, eventId, title,
+                                     date, description);
+    } catch ( std::bad_alloc& e) {
+        _arena.freeEvent( memory); /* the slot is not lost to the slab */
+        throw;
+    }
+
+    {
+        WriteGuard guard( shard.lock);
+        Slot& slot = shard.events[eventId];
+
+        slot.event = event;
+        slot.seq = _publish( event);
+        _addToClock( shard, slot);
+        _account( event->memoryDelta());
+    }
+
+    _spillIfOver();
+    return eventId;
+}
+
+
+/**
+ * @return: true if there is event with this id.
+ */
+bool EventStore::exists( int eventId)
+{
+    Shard& shard = _shardOf( eventId);
+    ReadGuard guard( shard.lock);
+
+    return shard.events.find( eventId) != shard.events.end();
+}
+
+
+/**
+ * @brief: add guest to the guests list of the event. RSVPs to events of
+ * one shard run in parallel.
+ * @param response: set to the result of the RSVP.
+ * @param status: set to the ResponseStatus of the RSVP.
+ * @return: false if there is no event with this id.
+ */
+bool EventStore::addGuest( int eventId, NameId guest, std::string& response,
+                           int& status)
+{
+    bool found;
+
+    /* the shard map is only read - the event locks its own guests list */
+    found = _withEvent( eventId, [&]( Event* event) {
+        response = event->registerClient( guest, status);
+    });
+    _spillIfOver();
+    return found;
+}
+
+
+/**
+ * @brief: the guest names of the event, sorted and separated by
+ * GUESTS_SEPARATOR - shared, cached until the guests change. readers of
+ * the same shard run in parallel.
+ * @return: false if there is no event with this id.
+ */
+bool EventStore::getGuestList( int eventId,
+                               std::shared_ptr<const std::string>& guests)
+{
+    bool found;
+
+    found = _withEvent( eventId, [&]( Event* event) {
+        guests = event->getGuestsText();
+    });
+    _spillIfOver();
+    return found;
+}
+
+
+/**
+ * @brief: a page of the guest names of the event - those after the name
+ * after (from the first if empty), at most limit of them. only the page is
+ * built, whatever the number of guests.
+ * @param next: set to the last name of the page if more follow it.
+ * @return: false if there is no event with this id.
+ */
+bool EventStore::getGuestPage( int eventId, StrRef after,
+                               size_t limit, std::string& page,
+                               std::string& next)
+{
+    bool found;
+
+    found = _withEvent( eventId, [&]( Event* event) {
+        event->getGuestsPage( after, limit, page, next);
+    });
+    _spillIfOver();
+    return found;
+}
+
+
+/**
+ * @brief: remove guest from the guests lists of the given events, one
+ * event at a time.
+ */
+void EventStore::removeGuest( const std::vector<int>& eventIds,
+                              NameId guest)
+{
+    std::vector<int>::const_iterator idIt;
+
+    for ( idIt = eventIds.begin(); idIt != eventIds.end(); ++idIt)
+    {
+        _withEvent( *idIt, [&]( Event* event) {
+            event->removeGuest( guest);
+        });
+    }
+    _spillIfOver();
+}
+
+
+/**
+ * @brief: set the max number of newest events that can be read - call
+ * before any event is created. the ring holds twice as many (rounded up to
+ * a power of two), so a reader is overrun only by that many creates.
+ */
+void EventStore::setNewestMax( int newestMax)
+{
+    size_t capacity = 1;
+
+    while ( capacity < (size_t) newestMax * 2) {
+        capacity *= 2;
+    }
+    _ring.reset( new std::atomic<const Event*>[capacity]);
+    _ringMask = capacity - 1;
+    _newestMax = newestMax;
+    _claimed = 0;
+    _published = 0;
+}
+
+
+/**
+ * @brief: append the newest count (at most newestMax) events, oldest
+ * first, each in the format of Event::toString, to text - and the offset
+ * in text of each event to records. the handles are read without a lock -
+ * if creates meanwhile overran the slots that were read, they are read
+ * again. the reader is counted in its epoch, so the events it read are not
+ * freed by a spill before it is done with them.
+ */
+void EventStore::newest( int count, std::string& text,
+                         std::vector<size_t>& records) const
+{
+    std::vector<const Event*> events;
+    std::vector<const Event*>::iterator it;
+    uint64_t first, end, i;
+    int parity;
+
+    count = std::max( 0, std::min( count, _newestMax));
+    parity = _enterNewest();
+    do {
+        events.clear();
+        end = _published.load( std::memory_order_seq_cst);
+        first = end > (uint64_t) count ? end - count : 0;
+        for ( i = first; i < end; ++i) {
+            events.push_back( _ring[i & _ringMask].load(
+                                            std::memory_order_acquire));
+        }
+    } while ( _claimed.load( std::memory_order_relaxed) - first > _ringMask);
+
+    for ( it = events.begin(); it != events.end(); ++it) {
+        records.push_back( text.size());
+        (*it)->appendTo( text);
+    }
+    _leaveNewest( parity);
+}
+
+
+/**
+ * @brief: spill cold events to disk once the events hold more than budget
+ * bytes (0 - never) - call before any event is created.
+ * @return: false if the segment file can not be created (errno is set).
+ */
+bool EventStore::setMemoryBudget( size_t budget)
+{
+    _budget = 0;
+    if ( budget > 0 && !_segment.open()) {
+        return false;
+    }
+    _budget = budget;
+    return true;
+}
+
+
+/**
+ * @return: the memory and spill statistics, empty without a budget.
+ */
+std::string EventStore::stats()
+{
+    if ( _budget == 0) {
+        return "";
+    }
+    return "events bytes " + std::to_string( _residentBytes.load()) +
+           " budget " + std::to_string( _budget) +
+           " arena " + std::to_string( _arena.bytes()) +
+           " spilled " + std::to_string( _spilled.load()) +
+           " paged in " + std::to_string( _pagedIn.load()) +
+           " segment " + std::to_string( _segment.size()) +
+           " free " + std::to_string( _segment.free());
+}
+
+
+/**
+ * @brief: delete all the events.
+ */
+void EventStore::clear()
+{
+    std::map<int, Slot>::iterator it;
+    int i;
+
+    {
+        std::lock_guard<std::mutex> guard( _publishLock);
+        _claimed = 0;
+        _published = 0;
+    }
+
+    for ( i = 0; i < NUM_EVENT_SHARDS; ++i)
+    {
+        WriteGuard guard( _shards[i].lock);
+        for ( it = _shards[i].events.begin(); it != _shards[i].events.end();
+              ++it) {
+            if ( it->second.event != nullptr) {
+                /* the arena memory is freed below */
+                it->second.event->~Event();
+            }
+        }
+        _shards[i].events.clear();
+        _shards[i].clock.clear();
+        _shards[i].hand = _shards[i].clock.end();
+    }
+
+    {
+        std::lock_guard<std::mutex> guard( _spillLock);
+        /* the arena memory is freed below */
+        _retired.insert( _retired.end(), _retiring.begin(), _retiring.end());
+        for ( i = 0; i < (int) _retired.size(); ++i) {
+            _retired[i]->~Event();
+        }
+        _retired.clear();
+        _retiring.clear();
+        _retiringWait = false;
+        _segment.close();
+        _residentBytes = 0;
+    }
+    _arena.clear();
+}
+
+/*************** Private Functions **************************************/
+
+/**
+ * @brief: publish event as the newest one - into the next ring slot. the
+ * slot is claimed before it is written, so a reader that saw the new
+ * handle also sees the claim and knows its read was overrun.
+ * @return: its number among the newest events.
+ */
+uint64_t EventStore::_publish( const Event* event)
+{
+    std::lock_guard<std::mutex> guard( _publishLock);
+    uint64_t next = _published.load( std::memory_order_relaxed);
+
+    _claimed.store( next + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence( std::memory_order_release);
+    _ring[next & _ringMask].store( event, std::memory_order_release);
+    _published.store( next + 1, std::memory_order_release);
+    return next;
+}
+
+
+/**
+ * @brief: count a reader of the ring in the current epoch - if the epoch
+ * was flipped meanwhile, the reader enters again in the new one, so a
+ * spill that flipped it sees every reader of the old one.
+ * @return: the parity of the epoch it entered in.
+ */
+int EventStore::_enterNewest() const
+{
+    uint64_t epoch;
+
+    while ( true)
+    {
+        epoch = _epoch.load( std::memory_order_seq_cst);
+        _newestReaders[epoch & 1].fetch_add( 1, std::memory_order_seq_cst);
+        if ( _epoch.load( std::memory_order_seq_cst) == epoch) {
+            return (int) (epoch & 1);
+        }
+        _newestReaders[epoch & 1].fetch_sub( 1, std::memory_order_release);
+    }
+}
+
+
+/**
+ * @brief: a reader of the ring that entered in parity is done.
+ */
+void EventStore::_leaveNewest( int parity) const
+{
+    _newestReaders[parity].fetch_sub( 1, std::memory_order_release);
+}
+
+
+/**
+ * @brief: put the event of slot, now in memory, on the clock of shard -
+ * just behind the hand, marked used. only with a budget, under the write
+ * lock of shard.
+ */
+void EventStore::_addToClock( Shard& shard, Slot& slot)
+{
+    if ( _budget == 0) {
+        return;
+    }
+    slot.used.store( true, std::memory_order_relaxed);
+    slot.clockAt = shard.clock.insert( shard.hand, &slot);
+}
+
+
+/**
+ * @brief: call use with the event under the read lock of its shard - a
+ * spilled event is read back first, and it is marked as used now. the
+ * change of its memory by use is counted.
+ * @return: false if there is no event with this id.
+ */
+template <typename Use>
+bool EventStore::_withEvent( int eventId, const Use& use)
+{
+    Shard& shard = _shardOf( eventId);
+    std::map<int, Slot>::iterator it;
+
+    while ( true)
+    {
+        {
+            ReadGuard guard( shard.lock);
+
+            it = shard.events.find( eventId);
+            if ( it == shard.events.end()) {
+                return false;
+            }
+            if ( it->second.event != nullptr) {
+                if ( !it->second.used.load( std::memory_order_relaxed)) {
+                    it->second.used.store( true, std::memory_order_relaxed);
+                }
+                use( it->second.event);
+                /* the guests and their cached list may have changed */
+                _account( it->second.event->memoryDelta());
+                return true;
+            }
+        }
+
+        /* spilled - it may be spilled again before it is used, then retry */
+        if ( !_pageIn( eventId)) {
+            return false;
+        }
+    }
+}
+
+
+/**
+ * @brief: read the spilled event back into memory from its record. its
+ * record is kept, so if it is spilled again unchanged it is not written.
+ * @return: false if there is no event with this id, or it can not be read.
+ */
+bool EventStore::_pageIn( int eventId)
+{
+    Shard& shard = _shardOf( eventId);
+    std::map<int, Slot>::iterator it;
+    std::string record;
+    void* memory;
+    Event* event;
+    WriteGuard guard( shard.lock);
+
+    it = shard.events.find( eventId);
+    if ( it == shard.events.end()) {
+        return false;
+    }
+    Slot& slot = it->second;
+    if ( slot.event != nullptr) {
+        return true; /* read back meanwhile */
+    }
+
+    if ( !_segment.read( slot.offset, slot.length, record)) {
+        return false;
+    }
+    try {
+        memory = _arena.allocEvent( sizeof( Event));
+    } catch ( std::bad_alloc& e) {
+        return false;
+    }
+    try {
+        event = new ( memory) Event( _arena, _names, record);
+    } catch ( std::bad_alloc& e) {
+        _arena.freeEvent( memory);
+        return false;
+    }
+
+    slot.event = event;
+    _addToClock( shard, slot);
+    _account( event->memoryDelta());
+    _pagedIn++;
+    return true;
+}
+
+
+/**
+ * @brief: spill cold events if over the budget, down to the budget less
+ * 1 / SPILL_SLACK of it, so a spill is not needed on each command. the
+ * shards are swept in turn, CLOCK_SWEEP_LEN events at a time, until a
+ * round over all of them spills nothing - then the next spill goes on
+ * from the hands. a batch of spilled events that waits for ring readers
+ * is freed even under the budget. one thread spills at a time, the others
+ * go on.
+ */
+void EventStore::_spillIfOver()
+{
+    uint64_t published;
+    size_t target = _budget - _budget / SPILL_SLACK;
+    bool over;
+    int idle = 0;
+
+    if ( _budget == 0) {
+        return;
+    }
+    over = _residentBytes.load( std::memory_order_relaxed) > _budget;
+    if ( !over && !_retiringWait.load( std::memory_order_relaxed)) {
+        return;
+    }
+    std::unique_lock<std::mutex> spill( _spillLock, std::try_to_lock);
+    if ( !spill.owns_lock()) {
+        return;
+    }
+
+    published = _published.load( std::memory_order_seq_cst);
+    while ( over && idle < NUM_EVENT_SHARDS &&
+            _residentBytes.load( std::memory_order_relaxed) > target) {
+        if ( _sweep( _shards[_clockShard], published, target)) {
+            idle = 0;
+        } else {
+            idle++;
+        }
+        _clockShard = (_clockShard + 1) & (NUM_EVENT_SHARDS - 1);
+    }
+    _freeRetired();
+}
+
+
+/**
+ * @brief: sweep at most CLOCK_SWEEP_LEN events of the clock of shard from
+ * its hand on, down to target bytes: an event used since the hand last
+ * passed it is only marked unused, one that was not is spilled. the
+ * newest events are passed over.
+ * @return: true if an event was spilled.
+ */
+bool EventStore::_sweep( Shard& shard, uint64_t published, size_t target)
+{
+    bool spilled = false;
+    Slot* slot;
+    int steps;
+    WriteGuard guard( shard.lock);
+
+    for ( steps = 0; steps < CLOCK_SWEEP_LEN && !shard.clock.empty() &&
+          _residentBytes.load( std::memory_order_relaxed) > target;
+          ++steps) {
+        if ( shard.hand == shard.clock.end()) {
+            shard.hand = shard.clock.begin();
+        }
+        slot = *shard.hand;
+        if ( slot->seq + _ringMask + 1 >= published) {
+            ++shard.hand; /* still in the ring */
+        } else if ( slot->used.load( std::memory_order_relaxed)) {
+            slot->used.store( false, std::memory_order_relaxed);
+            ++shard.hand;
+        } else if ( _spill( shard, *slot)) {
+            spilled = true;
+        } else {
+            ++shard.hand;
+        }
+    }
+    return spilled;
+}
+
+
+/**
+ * @brief: spill the event of slot - write its record (unless the one it
+ * was read from is unchanged), take it off the clock and retire it. an out
+ * of date record is released, so its space is reused. under the write
+ * lock of shard.
+ * @return: false if its record can not be written - it stays in memory.
+ */
+bool EventStore::_spill( Shard& shard, Slot& slot)
+{
+    Event* event = slot.event;
+    std::string record;
+    uint64_t offset;
+
+    if ( slot.length == 0 || event->guestsVersion() != 0) {
+        event->serialize( record);
+        _segment.release( slot.offset, slot.length);
+        slot.length = 0;
+        if ( !_segment.append( record, offset)) {
+            return false;
+        }
+        slot.offset = offset;
+        slot.length = record.size();
+    }
+
+    if ( shard.hand == slot.clockAt) {
+        ++shard.hand;
+    }
+    shard.clock.erase( slot.clockAt);
+    slot.event = nullptr;
+    _account( -(ssize_t) event->memoryCounted());
+    _retired.push_back( event);
+    _spilled++;
+    return true;
+}
+
+
+/**
+ * @brief: free the spilled events no ring reader can hold. the events
+ * spilled since the last flip of the epoch are a batch: the epoch is
+ * flipped once the batch before is freed, and the batch is freed once the
+ * readers that entered before the flip are done. readers that enter after
+ * it can not see the batch - its events left the ring before they were
+ * spilled - so readers that come all the time do not hold it back.
+ */
+void EventStore::_freeRetired()
+{
+    uint64_t epoch = _epoch.load( std::memory_order_relaxed);
+
+    if ( !_retiring.empty()) {
+        if ( _newestReaders[(epoch - 1) & 1].load(
+                                        std::memory_order_seq_cst) != 0) {
+            return; /* freed by the next spill */
+        }
+        _freeEvents( _retiring);
+    }
+    if ( !_retired.empty()) {
+        _retiring.swap( _retired);
+        _epoch.store( epoch + 1, std::memory_order_seq_cst);
+        if ( _newestReaders[epoch & 1].load(
+                                        std::memory_order_seq_cst) == 0) {
+            _freeEvents( _retiring);
+        }
+    }
+    _retiringWait.store( !_retiring.empty(), std::memory_order_relaxed);
+}
+
+
+/**
+ * @brief: destroy the events and free their memory.
+ */
+void EventStore::_freeEvents( std::vector<Event*>& events)
+{
+    std::vector<Event*>::iterator it;
+
+    for ( it = events.begin(); it != events.end(); ++it) {
+        (*it)->releaseText( _arena);
+        (*it)->~Event();
+        _arena.freeEvent( *it);
+    }
+    events.clear();
+}
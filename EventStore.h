@@ -0,0 +1,296 @@
+/*
+ * EventStore.h
+ * Created on: Oct 17, 2026
+ * Author: nicole
+ */
+
+#ifndef EVENTSTORE_H_
+#define EVENTSTORE_H_
+
+#include <string>
+#include <vector>
+#include <list>
+#include <map>
+#include <stdint.h>
+#include <atomic>
+#include <memory> // unique_ptr
+#include <new> // placement new
+#include <mutex>
+#include <algorithm> // min, max
+
+#include "Event.h"
+#include "RWLock.h"
+#include "IdAllocator.h"
+#include "EventArena.h"
+#include "EventSegment.h"
+
+/* number of event shards - a power of two */
+#define NUM_EVENT_SHARDS 16
+/* default max number of newest events a GET_TOP can ask for */
+#define DEFAULT_NEWEST_MAX 100
+/* upper bound of that max - the ring holds twice as many handles */
+#define MAX_NEWEST_MAX (1 << 20)
+/* a spill frees memory down to the budget less 1 / SPILL_SLACK of it */
+#define SPILL_SLACK 8
+/* events of one shard a spill sweeps before it moves to the next shard */
+#define CLOCK_SWEEP_LEN 64
+
+
+/**
+ * A concurrent store of the server events, sharded by event id. Each shard
+ * has its own reader/writer lock over its map, so commands on events of
+ * different shards never wait for each other and lookups of one shard run
+ * in parallel - the map is only written by create. an event guards its own
+ * guests list. the events are allocated from an arena and freed together.
+ * the newest events are published into a fixed ring buffer of event
+ * handles, so reading the newest n of them takes no lock and costs O(n)
+ * whatever the number of events created.
+ * with a memory budget, once the events hold more than it the cold events
+ * are serialized to an EventSegment and freed, and are read back when a
+ * command needs them. each shard keeps its events in memory on a clock: a
+ * spill sweeps the shards in turn from their hands and spills the events
+ * not used since the hand last passed them. the newest events - those in
+ * the ring - are never spilled.
+ */
+class EventStore
+{
+public:
+
+    /**
+     * @brief: Constructor - names are the names of the guest ids.
+     */
+    EventStore( const NameTable& names);
+
+    /**
+     * destructor - deletes all the events.
+     */
+    virtual ~EventStore();
+
+    EventStore( EventStore const &other) = delete;
+    void operator=( EventStore const &other) = delete;
+
+    /**
+     * @brief: create a new event with a new unique event id.
+     * @return: the new event id.
+     * @throw: std::bad_alloc if the event can not be allocated.
+     */
+    int create( StrRef creator, StrRef title, StrRef date,
+                StrRef description);
+
+    /**
+     * @return: true if there is event with this id.
+     */
+    bool exists( int eventId);
+
+    /**
+     * @brief: add guest to the guests list of the event.
+     * @param response: set to the result of the RSVP.
+     * @param status: set to the ResponseStatus of the RSVP.
+     * @return: false if there is no event with this id.
+     */
+    bool addGuest( int eventId, NameId guest, std::string& response,
+                   int& status);
+
+    /**
+     * @brief: the guest names of the event, sorted and separated by
+     * GUESTS_SEPARATOR - shared, cached until the guests change.
+     * @return: false if there is no event with this id.
+     */
+    bool getGuestList( int eventId, std::shared_ptr<const std::string>& guests);
+
+    /**
+     * @brief: a page of the guest names of the event - those after the name
+     * after (from the first if empty), at most limit of them.
+     * @param next: set to the last name of the page if more follow it.
+     * @return: false if there is no event with this id.
+     */
+    bool getGuestPage( int eventId, StrRef after, size_t limit,
+                       std::string& page, std::string& next);
+
+    /**
+     * @brief: remove guest from the guests lists of the given events.
+     */
+    void removeGuest( const std::vector<int>& eventIds, NameId guest);
+
+    /**
+     * @brief: set the max number of newest events that can be read - call
+     * before any event is created.
+     */
+    void setNewestMax( int newestMax);
+
+    /**
+     * @return: the max number of newest events that can be read.
+     */
+    int newestMax() const {
+        return _newestMax;
+    }
+
+    /**
+     * @return: the version of the newest events - bumped by each create.
+     */
+    uint64_t newestVersion() const {
+        return _published.load( std::memory_order_acquire);
+    }
+
+    /**
+     * @brief: append the newest count (at most newestMax) events, oldest
+     * first, each in the format of Event::toString, to text - and the
+     * offset in text of each event to records.
+     */
+    void newest( int count, std::string& text,
+                 std::vector<size_t>& records) const;
+
+    /**
+     * @brief: spill cold events to disk once the events hold more than
+     * budget bytes (0 - never) - call before any event is created.
+     * @return: false if the segment file can not be created (errno is set).
+     */
+    bool setMemoryBudget( size_t budget);
+
+    /**
+     * @return: the memory and spill statistics, empty without a budget.
+     */
+    std::string stats();
+
+    /**
+     * @brief: delete all the events.
+     */
+    void clear();
+
+private:
+
+    struct Slot
+    {
+        Event* event;     /* null while spilled */
+        uint64_t seq;     /* number of the event among the newest */
+        std::atomic<bool> used; /* used since the clock hand passed it */
+        std::list<Slot*>::iterator clockAt; /* while in memory, budget only */
+        uint64_t offset;  /* its record in the segment */
+        uint32_t length;  /* length of the record, 0 if never spilled */
+
+        Slot(): event( nullptr), seq( 0), used( false), offset( 0),
+                length( 0) {}
+    };
+
+    struct Shard
+    {
+        RWLock lock;
+        std::map<int /*eventId*/, Slot> events;
+        /* the events in memory - a new one is put just behind the hand, so
+         * it is swept last */
+        std::list<Slot*> clock;
+        std::list<Slot*>::iterator hand;
+
+        Shard(): hand( clock.end()) {}
+    };
+
+    const NameTable& _names;
+    Shard _shards[NUM_EVENT_SHARDS];
+    IdAllocator _ids;
+    EventArena _arena; /* the memory of all the events */
+    std::mutex _publishLock; /* serializes the ring writers */
+    int _newestMax;
+    /* the newest events - event number i is in slot i & _ringMask */
+    std::unique_ptr<std::atomic<const Event*>[]> _ring;
+    size_t _ringMask;
+    std::atomic<uint64_t> _claimed;   /* events being published or published */
+    std::atomic<uint64_t> _published; /* events published */
+    std::atomic<uint64_t> _epoch; /* flipped by each retired batch */
+    /* readers of the ring, by the parity of the epoch they entered in */
+    mutable std::atomic<int> _newestReaders[2];
+    size_t _budget;   /* bytes of the events in memory, 0 - no budget */
+    std::atomic<size_t> _residentBytes; /* counted only with a budget */
+    EventSegment _segment;
+    std::mutex _spillLock; /* one spill at a time, guards the batches */
+    int _clockShard; /* the shard a spill sweeps first */
+    std::vector<Event*> _retired;  /* spilled since the last flip */
+    std::vector<Event*> _retiring; /* spilled before it, wait for readers */
+    std::atomic<bool> _retiringWait; /* _retiring is not empty */
+    std::atomic<uint64_t> _spilled;
+    std::atomic<uint64_t> _pagedIn;
+
+    /**
+     * @brief: publish event as the newest one.
+     * @return: its number among the newest events.
+     */
+    uint64_t _publish( const Event* event);
+
+    /**
+     * @brief: count a reader of the ring in the current epoch.
+     * @return: the parity of the epoch it entered in.
+     */
+    int _enterNewest() const;
+
+    /**
+     * @brief: a reader of the ring that entered in parity is done.
+     */
+    void _leaveNewest( int parity) const;
+
+    /**
+     * @brief: put the event of slot, now in memory, on the clock of shard.
+     */
+    void _addToClock( Shard& shard, Slot& slot);
+
+    /**
+     * @brief: call use with the event, read back from disk if spilled,
+     * under the read lock of its shard.
+     * use is a callable taking Event*, only called in EventStore.cpp.
+     * @return: false if there is no event with this id.
+     */
+    template <typename Use>
+    bool _withEvent( int eventId, const Use& use);
+
+    /**
+     * @brief: read the spilled event back into memory.
+     * @return: false if there is no event with this id, or it can not be
+     * read.
+     */
+    bool _pageIn( int eventId);
+
+    /**
+     * @brief: spill cold events if over the budget.
+     */
+    void _spillIfOver();
+
+    /**
+     * @brief: sweep the clock of shard and spill the events not used since
+     * the hand last passed them, down to target bytes.
+     * @return: true if an event was spilled.
+     */
+    bool _sweep( Shard& shard, uint64_t published, size_t target);
+
+    /**
+     * @brief: spill the event of slot - under the write lock of shard.
+     * @return: false if its record can not be written.
+     */
+    bool _spill( Shard& shard, Slot& slot);
+
+    /**
+     * @brief: free the spilled events no ring reader can hold.
+     */
+    void _freeRetired();
+
+    /**
+     * @brief: destroy the events and free their memory.
+     */
+    void _freeEvents( std::vector<Event*>& events);
+
+    /**
+     * @brief: add delta to the bytes of the events in memory.
+     */
+    void _account( ssize_t delta) {
+        if ( _budget > 0) {
+            _residentBytes.fetch_add( (size_t) delta,
+                                     std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @return: the shard of the event id.
+     */
+    Shard& _shardOf( int eventId) {
+        return _shards[eventId & (NUM_EVENT_SHARDS - 1)];
+    }
+};
+
+#endif /* EVENTSTORE_H_ */
@@ -0,0 +1,310 @@
+/*
+ * GuestSet.cpp
+ * Created on: Oct 17, 2026
+ * Author: nicole
+ */
+
+#include "GuestSet.h"
+
+/**
+ * @brief: Constructor - names are the names of the guest ids.
+ */
+GuestSet::GuestSet( const NameTable& names): _names( names),
+        _index( GUEST_INDEX_MIN, Slot{ NO_NAME, EMPTY }), _size( 0),
+        _used( 0), _blockBytes( 0)
+{}
+
+
+GuestSet::~GuestSet()
+{}
+
+
+/**
+ * @brief: add guest at the end of the RSVP order and in its sorted place in
+ * the view. the index is grown when more than half of its slots are in use.
+ * @return: false if guest is already in the set.
+ */
+bool GuestSet::insert( NameId guest)
+{
+    ByName byName( _names);
+    size_t b, capacity;
+    Block* block;
+
+    if ( _find( guest) >= 0) {
+        return false;
+    }
+
+    if ( (_used + 1) * 2 > _index.size()) {
+        /* tombstones are dropped by the rebuild - grow only if needed */
+        _rebuild( (_size + 1) * 2 > _index.size() / 2 ? _index.size() * 2 :
+                                                        _index.size());
+    }
+    _place( guest, (int32_t) _order.size());
+    _order.push_back( guest);
+    _size++;
+
+    if ( _blocks.empty()) {
+        _blocks.push_back( Block( 1, guest));
+        _blockBytes += _blocks.back().capacity() * sizeof( NameId);
+        return true;
+    }
+    b = _blockOf( guest);
+    block = &_blocks[b];
+    capacity = block->capacity();
+    block->insert( std::upper_bound( block->begin(), block->end(), guest,
+                                     byName), guest);
+    _blockBytes += (block->capacity() - capacity) * sizeof( NameId);
+    if ( block->size() > GUEST_BLOCK_LEN) {
+        /* split - the second half moves to a new block after it */
+        Block second( block->begin() + block->size() / 2, block->end());
+        block->resize( block->size() / 2);
+        _blockBytes += second.capacity() * sizeof( NameId);
+        _blocks.insert( _blocks.begin() + b + 1, std::move( second));
+    }
+    return true;
+}
+
+
+/**
+ * @brief: remove guest - its RSVP order slot becomes a tombstone and it is
+ * erased from its block of the sorted view.
+ * @return: false if guest is not in the set.
+ */
+bool GuestSet::remove( NameId guest)
+{
+    long pos = _find( guest);
+    size_t b;
+    Block* block;
+
+    if ( pos < 0) {
+        return false;
+    }
+
+    _order[_index[pos].at] = NO_NAME;
+    _index[pos].at = DELETED;
+    _size--;
+
+    b = _blockOf( guest);
+    block = &_blocks[b];
+    block->erase( std::lower_bound( block->begin(), block->end(), guest,
+                                    ByName( _names)));
+    if ( block->empty()) {
+        _blockBytes -= block->capacity() * sizeof( NameId);
+        _blocks.erase( _blocks.begin() + b);
+    }
+
+    /* compact once the tombstones are the majority */
+    if ( _order.size() > GUEST_INDEX_MIN && _size * 2 < _order.size()) {
+        _rebuild( _index.size());
+    }
+    return true;
+}
+
+
+/**
+ * @return: true if guest is in the set.
+ */
+bool GuestSet::contains( NameId guest) const
+{
+    return _find( guest) >= 0;
+}
+
+
+/**
+ * @brief: append the guest names, sorted and separated by sep, to out.
+ */
+void GuestSet::appendNames( std::string& out, const std::string& sep) const
+{
+    std::vector<Block>::const_iterator block;
+    Block::const_iterator it;
+
+    for ( block = _blocks.begin(); block != _blocks.end(); ++block) {
+        for ( it = block->begin(); it != block->end(); ++it) {
+            if ( block != _blocks.begin() || it != block->begin()) {
+                out += sep;
+            }
+            out += _names.name( *it);
+        }
+    }
+}
+
+/**
+ * @brief: append a page of the guest names, sorted and separated by sep,
+ * to out - the names after the name after (from the first if empty), at
+ * most limit of them and maxLen bytes, but at least one. a page starts by
+ * a binary search for after, so a cursor stays valid while guests come and
+ * go, and the page is built alone.
+ * @param next: set to the last name of the page if more follow it,
+ * otherwise emptied.
+ */
+void GuestSet::appendPage( std::string& out, const std::string& sep,
+                           StrRef after, size_t limit,
+                           size_t maxLen, std::string& next) const
+{
+    ByName byName( _names);
+    size_t b = 0, i = 0;
+    size_t count = 0, len = 0;
+    NameId last = NO_NAME;
+
+    if ( !after.empty() && !_blocks.empty()) {
+        b = std::upper_bound( _blocks.begin(), _blocks.end(), after,
+                              byName) - _blocks.begin();
+        b = b > 0 ? b - 1 : 0;
+        i = std::upper_bound( _blocks[b].begin(), _blocks[b].end(), after,
+                              byName) - _blocks[b].begin();
+    }
+
+    next.clear();
+    for ( ; b < _blocks.size(); ++b, i = 0) {
+        for ( ; i < _blocks[b].size(); ++i) {
+            const std::string& name = _names.name( _blocks[b][i]);
+
+            if ( count == limit ||
+                 (count > 0 && len + sep.size() + name.size() > maxLen)) {
+                next = _names.name( last);
+                return;
+            }
+            if ( count > 0) {
+                out += sep;
+                len += sep.size();
+            }
+            out += name;
+            len += name.size();
+            last = _blocks[b][i];
+            count++;
+        }
+    }
+}
+
+
+/**
+ * @brief: append the guest ids, in RSVP order, to out.
+ */
+void GuestSet::appendIds( std::string& out) const
+{
+    std::vector<NameId>::const_iterator it;
+
+    out.reserve( out.size() + _size * sizeof( NameId));
+    for ( it = _order.begin(); it != _order.end(); ++it) {
+        if ( *it != NO_NAME) {
+            out.append( (const char*) &*it, sizeof( NameId));
+        }
+    }
+}
+
+
+/**
+ * @brief: replace the guests with the given ids, in RSVP order - the index
+ * is built at once and the sorted view is cut from one sorted copy.
+ */
+void GuestSet::assign( const std::vector<NameId>& guests)
+{
+    std::vector<NameId> sorted( guests);
+    size_t capacity = GUEST_INDEX_MIN;
+    size_t i;
+
+    while ( capacity < (guests.size() + 1) * 2) {
+        capacity *= 2;
+    }
+    _order = guests;
+    _size = guests.size();
+    _rebuild( capacity);
+
+    std::sort( sorted.begin(), sorted.end(), ByName( _names));
+    _blocks.clear();
+    _blockBytes = 0;
+    for ( i = 0; i < sorted.size(); i += GUEST_BLOCK_LEN / 2) {
+        _blocks.push_back( Block( sorted.begin() + i, sorted.begin() +
+                std::min( i + GUEST_BLOCK_LEN / 2, sorted.size())));
+        _blockBytes += _blocks.back().capacity() * sizeof( NameId);
+    }
+}
+
+
+/**
+ * @return: bytes held by the set - the capacity of the RSVP order, of the
+ * index and of the sorted view with its blocks. the blocks are counted as
+ * they change, so this does not walk them.
+ */
+size_t GuestSet::memoryUsage() const
+{
+    return _order.capacity() * sizeof( NameId) +
+           _index.capacity() * sizeof( Slot) +
+           _blocks.capacity() * sizeof( Block) + _blockBytes;
+}
+
+/*************** Private Functions **************************************/
+
+/**
+ * @return: the index slot that holds guest, or -1 if it is not there.
+ */
+long GuestSet::_find( NameId guest) const
+{
+    size_t mask = _index.size() - 1;
+    size_t pos = (size_t) (guest * GUEST_HASH_MUL) & mask;
+
+    /* the index is never full, so the probe ends at an EMPTY slot */
+    while ( _index[pos].at != EMPTY) {
+        if ( _index[pos].at >= 0 && _index[pos].guest == guest) {
+            return (long) pos;
+        }
+        pos = (pos + 1) & mask;
+    }
+    return -1;
+}
+
+
+/**
+ * @brief: put guest at position at in a free slot of the index.
+ */
+void GuestSet::_place( NameId guest, int32_t at)
+{
+    size_t mask = _index.size() - 1;
+    size_t pos = (size_t) (guest * GUEST_HASH_MUL) & mask;
+
+    while ( _index[pos].at >= 0) {
+        pos = (pos + 1) & mask;
+    }
+    if ( _index[pos].at == EMPTY) {
+        _used++;
+    }
+    _index[pos].guest = guest;
+    _index[pos].at = at;
+}
+
+
+/**
+ * @brief: rebuild the index with the given capacity, dropping the
+ * tombstones of the RSVP order (the order is kept).
+ */
+void GuestSet::_rebuild( size_t capacity)
+{
+    size_t i, kept = 0;
+
+    for ( i = 0; i < _order.size(); ++i) {
+        if ( _order[i] != NO_NAME) {
+            _order[kept++] = _order[i];
+        }
+    }
+    _order.resize( kept);
+
+    _index.assign( capacity, Slot{ NO_NAME, EMPTY });
+    _used = 0;
+    for ( i = 0; i < _order.size(); ++i) {
+        _place( _order[i], (int32_t) i);
+    }
+}
+
+
+/**
+ * @return: the block of the sorted view guest belongs in - its first name
+ * is not after the name of guest, unless it is the first block.
+ */
+size_t GuestSet::_blockOf( NameId guest) const
+{
+    std::vector<Block>::const_iterator block =
+            std::upper_bound( _blocks.begin(), _blocks.end(), guest,
+                              ByName( _names));
+
+    return block == _blocks.begin() ? 0 : block - _blocks.begin() - 1;
+}
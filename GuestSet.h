@@ -0,0 +1,173 @@
+/*
+ * GuestSet.h
+ * Created on: Oct 17, 2026
+ * Author: nicole
+ */
+
+#ifndef GUESTSET_H_
+#define GUESTSET_H_
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <algorithm> // upper_bound, lower_bound, sort
+
+#include "NameTable.h"
+#include "CommandParser.h"
+
+/* smallest capacity of the hash index - a power of two */
+#define GUEST_INDEX_MIN 16
+/* multiplier of the guest id hash (32 bit golden ratio) */
+#define GUEST_HASH_MUL 2654435761u
+/* most guests in one block of the sorted view */
+#define GUEST_BLOCK_LEN 256
+
+
+/**
+ * The guests of an event, in RSVP order, with O(1) lookup, and a view of
+ * them sorted by name (case insensitive, as the RSVP list is printed). The
+ * guests are kept by their NameTable ids in a dense vector in RSVP order -
+ * a removed guest leaves a tombstone that is compacted away once
+ * tombstones are the majority - and an open addressing hash index (linear
+ * probing) maps an id to its position in the vector. The sorted view is a
+ * list of sorted blocks of at most GUEST_BLOCK_LEN ids, as the leaves of a
+ * B-tree: a guest is placed by a binary search on the first names of the
+ * blocks and then in its block, and only the ids after it in that block
+ * are shifted. a full block is split in two, an empty one is dropped.
+ */
+class GuestSet
+{
+public:
+
+    /**
+     * @brief: Constructor - names are the names of the guest ids.
+     */
+    GuestSet( const NameTable& names);
+
+    virtual ~GuestSet();
+
+    /**
+     * @brief: add guest at the end of the RSVP order.
+     * @return: false if guest is already in the set.
+     */
+    bool insert( NameId guest);
+
+    /**
+     * @brief: remove guest.
+     * @return: false if guest is not in the set.
+     */
+    bool remove( NameId guest);
+
+    /**
+     * @return: true if guest is in the set.
+     */
+    bool contains( NameId guest) const;
+
+    /**
+     * @return: number of guests.
+     */
+    size_t size() const {
+        return _size;
+    }
+
+    /**
+     * @brief: append the guest names, sorted and separated by sep, to out.
+     */
+    void appendNames( std::string& out, const std::string& sep) const;
+
+    /**
+     * @brief: append a page of the guest names - the names after the name
+     * after (from the first if empty), at most limit of them and maxLen
+     * bytes - sorted and separated by sep, to out.
+     * @param next: set to the last name of the page if more follow it,
+     * otherwise emptied.
+     */
+    void appendPage( std::string& out, const std::string& sep,
+                     StrRef after, size_t limit, size_t maxLen,
+                     std::string& next) const;
+
+    /**
+     * @brief: append the guest ids, in RSVP order, to out.
+     */
+    void appendIds( std::string& out) const;
+
+    /**
+     * @brief: replace the guests with the given ids, in RSVP order.
+     */
+    void assign( const std::vector<NameId>& guests);
+
+    /**
+     * @return: bytes held by the set - the capacity of its vectors and of
+     * every block.
+     */
+    size_t memoryUsage() const;
+
+private:
+
+    /* index slot values other than a position in _order */
+    enum { EMPTY = -1, DELETED = -2 };
+
+    struct Slot
+    {
+        NameId guest;
+        int32_t at; /* position in _order */
+    };
+
+    typedef std::vector<NameId> Block;
+
+    /**
+     * orders ids by their names, as the RSVP list is printed.
+     */
+    struct ByName
+    {
+        const NameTable& names;
+
+        ByName( const NameTable& names): names( names) {}
+
+        bool operator()( NameId a, NameId b) const {
+            return CommandParser::compare_nocase( names.name( a),
+                                                  names.name( b));
+        }
+        bool operator()( StrRef name, NameId guest) const {
+            return CommandParser::compare_nocase( name, names.name( guest));
+        }
+        bool operator()( NameId guest, const Block& block) const {
+            return (*this)( guest, block.front());
+        }
+        bool operator()( StrRef name, const Block& block) const {
+            return (*this)( name, block.front());
+        }
+    };
+
+    const NameTable& _names;
+    std::vector<NameId> _order; /* the guests in RSVP order */
+    std::vector<Slot> _index;   /* open addressing, by guest id */
+    std::vector<Block> _blocks; /* the sorted view - none is empty */
+    size_t _size;               /* guests in the set */
+    size_t _used;               /* index slots that are not EMPTY */
+    size_t _blockBytes;         /* capacity of all the blocks, in bytes */
+
+    /**
+     * @return: the index slot that holds guest, or -1 if it is not there.
+     */
+    long _find( NameId guest) const;
+
+    /**
+     * @brief: put guest at position at in a free slot of the index.
+     */
+    void _place( NameId guest, int32_t at);
+
+    /**
+     * @brief: rebuild the index with the given capacity, dropping the
+     * tombstones of the RSVP order.
+     */
+    void _rebuild( size_t capacity);
+
+    /**
+     * @return: the block of the sorted view guest belongs in - its first
+     * name is not after the name of guest, unless it is the first block.
+     */
+    size_t _blockOf( NameId guest) const;
+};
+
+#endif /* GUESTSET_H_ */
@@ -0,0 +1,46 @@
+/*
+ * IdAllocator.cpp
+ * Created on: Oct 17, 2026
+ * Author: nicole
+ */
+
+#include "IdAllocator.h"
+
+/**
+ * the block of ids the calling thread hands out - [next, end) of owner.
+ */
+struct IdBlock
+{
+    const IdAllocator* owner;
+    int next;
+    int end;
+};
+
+static thread_local IdBlock block = { nullptr, 0, 0 };
+
+
+/**
+ * @brief: Constructor - the first block starts at firstId.
+ */
+IdAllocator::IdAllocator( int firstId): _nextBlock( firstId)
+{}
+
+
+IdAllocator::~IdAllocator()
+{}
+
+
+/**
+ * @return: the next id of the calling thread - a new block is taken from
+ * the shared counter when the thread used up its block.
+ */
+int IdAllocator::next()
+{
+    if ( block.owner != this || block.next == block.end) {
+        block.owner = this;
+        block.next = _nextBlock.fetch_add( ID_BLOCK_SIZE,
+                                           std::memory_order_relaxed);
+        block.end = block.next + ID_BLOCK_SIZE;
+    }
+    return block.next++;
+}
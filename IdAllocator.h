@@ -0,0 +1,51 @@
+/*
+ * IdAllocator.h
+ * Created on: Oct 17, 2026
+ * Author: nicole
+ */
+
+#ifndef IDALLOCATOR_H_
+#define IDALLOCATOR_H_
+
+#include <atomic>
+
+/* number of ids a thread takes from the shared counter at once */
+#define ID_BLOCK_SIZE 32
+/* size of a cache line - the shared counter is alone on its line */
+#define CACHE_LINE_SIZE 64
+
+
+/**
+ * A lock free allocator of unique positive ids. Each thread takes a block
+ * of ID_BLOCK_SIZE ids from the shared atomic counter and hands them out
+ * one by one, so the counter (and its cache line) is touched once per
+ * block instead of once per id. ids are unique and roughly increasing -
+ * the ids of one thread increase, a block left unused by a thread is a gap.
+ */
+class IdAllocator
+{
+public:
+
+    /**
+     * @brief: Constructor - the first block starts at firstId.
+     */
+    IdAllocator( int firstId = 1);
+
+    virtual ~IdAllocator();
+
+    IdAllocator( IdAllocator const &other) = delete;
+    void operator=( IdAllocator const &other) = delete;
+
+    /**
+     * @return: the next id of the calling thread.
+     */
+    int next();
+
+private:
+
+    /* first id of the next block - aligned, so the allocator fills a
+     * cache line of its own */
+    alignas(CACHE_LINE_SIZE) std::atomic<int> _nextBlock;
+};
+
+#endif /* IDALLOCATOR_H_ */
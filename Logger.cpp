@@ -22,24 +22,41 @@ Logger::~Logger()
  */
 void Logger::logCommand( const std::string command)
 {
-	time_t current_time;
-	struct tm * time_info;
 	std::string line;
-	char timeString[9];  // space for "HH:MM:SS\0"
 
 	if ( _logFile.is_open())
 	{
-		time(&current_time);
-		time_info = localtime( &current_time);
+		line = _formatLine( command);
 
-		strftime( timeString, sizeof(timeString), "%H:%M:%S", time_info);
-		line = std::string(timeString) + " \t" + command + "\n";
+		std::lock_guard<std::mutex> guard( _lock);
 		_logFile << line;
 		flushLogFile();
 	}
 }
 
 
+/**
+ * @brief: document a group of operations to the log file at once - one
+ * write and one flush.
+ */
+void Logger::logCommands( const std::vector<std::string>& commands)
+{
+	std::vector<std::string>::const_iterator it;
+	std::string lines;
+
+	if ( _logFile.is_open() && !commands.empty())
+	{
+		for ( it = commands.begin(); it != commands.end(); ++it) {
+			lines += _formatLine( *it);
+		}
+
+		std::lock_guard<std::mutex> guard( _lock);
+		_logFile << lines;
+		flushLogFile();
+	}
+}
+
+
 void Logger::logEvent(int ID, const std::string title,const std::string time,
 						  const std::string description)
 {
@@ -87,6 +104,22 @@ void Logger::closeLog()
     }
 }
 
+/**
+ * @return: the log line of command - prefixed by the current time.
+ */
+std::string Logger::_formatLine( const std::string& command)
+{
+	time_t current_time;
+	struct tm time_info;
+	char timeString[9];  // space for "HH:MM:SS\0"
+
+	time(&current_time);
+	localtime_r( &current_time, &time_info);
+
+	strftime( timeString, sizeof(timeString), "%H:%M:%S", &time_info);
+	return std::string(timeString) + " \t" + command + "\n";
+}
+
 /**
  * @brief: create a new log file in the root dir.
  * @param rootDir: log's file root dir.
@@ -16,6 +16,8 @@
 #include <string>
 #include <string.h>
 #include <sys/types.h> // for size_t, off_t
+#include <mutex>
+#include <vector>
 
 
 class Logger
@@ -32,6 +34,12 @@ public:
 	 */
 	void logCommand( const std::string command);
 
+	/**
+	 * @brief: document a group of operations to the log file at once - one
+	 * write and one flush.
+	 */
+	void logCommands( const std::vector<std::string>& commands);
+
 
 	void logEvent( int ID, const std::string title, const std::string time,
 				   const std::string description);
@@ -56,8 +64,14 @@ private:
 
 	std::string _logPath; /* absolute log path. */
 	std::fstream _logFile;
+	std::mutex _lock; /* commands are logged from many threads */
 
 
+	/**
+	 * @return: the log line of command - prefixed by the current time.
+	 */
+	std::string _formatLine( const std::string& command);
+
 	/**
 	 * @brief: create a new log file in the root dir.
 	 * @param rootDir: log's file root dir.
@@ -0,0 +1,86 @@
+/*
+ * NameTable.cpp
+ * Created on: Oct 17, 2026
+ * Author: nicole
+ */
+
+#include "NameTable.h"
+
+NameTable::NameTable(): _count( 0)
+{
+    int i;
+
+    for ( i = 0; i < MAX_NAME_CHUNKS; ++i) {
+        _chunks[i] = nullptr;
+    }
+}
+
+
+/**
+ * destructor - frees the id -> name table.
+ */
+NameTable::~NameTable()
+{
+    int i;
+
+    for ( i = 0; i < MAX_NAME_CHUNKS; ++i) {
+        delete[] _chunks[i];
+    }
+}
+
+
+/**
+ * @brief: intern the (case insensitive) name. a known name is found under
+ * the read lock, only a new one takes the write lock.
+ * @return: the id of the name - a new one if it is new, or NO_NAME if it is
+ * new and the table is full.
+ */
+NameId NameTable::intern( const std::string& name)
+{
+    std::string key;
+    IdMap::iterator it;
+
+    {
+        ReadGuard guard( _lock);
+        it = _ids.find( name);
+        if ( it != _ids.end()) {
+            return it->second;
+        }
+    }
+
+    /* a new name is kept in upper case, as it is listed */
+    key = name;
+    CaseFold::toUpper( key);
+
+    WriteGuard guard( _lock);
+    /* may have been interned meanwhile */
+    it = _ids.find( key);
+    if ( it != _ids.end()) {
+        return it->second;
+    }
+    if ( _count == (NameId) NAME_CHUNK_LEN * MAX_NAME_CHUNKS) {
+        return NO_NAME;
+    }
+    if ( _chunks[_count / NAME_CHUNK_LEN] == nullptr) {
+        _chunks[_count / NAME_CHUNK_LEN] =
+                new const std::string*[NAME_CHUNK_LEN];
+    }
+
+    it = _ids.insert( std::make_pair( std::move( key), _count)).first;
+    _chunks[_count / NAME_CHUNK_LEN][_count % NAME_CHUNK_LEN] = &it->first;
+    return _count++;
+}
+
+
+/**
+ * @return: the id of the (case insensitive) name, or NO_NAME if it was
+ * never interned. the name is hashed and compared as given.
+ */
+NameId NameTable::find( const std::string& name)
+{
+    IdMap::iterator it;
+    ReadGuard guard( _lock);
+
+    it = _ids.find( name);
+    return it == _ids.end() ? NO_NAME : it->second;
+}
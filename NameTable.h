@@ -0,0 +1,86 @@
+/*
+ * NameTable.h
+ * Created on: Oct 17, 2026
+ * Author: nicole
+ */
+
+#ifndef NAMETABLE_H_
+#define NAMETABLE_H_
+
+#include <stdint.h>
+#include <string>
+#include <unordered_map>
+
+#include "RWLock.h"
+#include "CaseFold.h"
+
+/* compact id of an interned client name */
+typedef uint32_t NameId;
+
+/* id of a name that was never interned */
+#define NO_NAME ((NameId) 0xFFFFFFFF)
+/* names of one chunk of the id -> name table */
+#define NAME_CHUNK_LEN 4096
+/* chunks of the id -> name table - at most 16M names */
+#define MAX_NAME_CHUNKS 4096
+
+
+/**
+ * Interns the client names: each case folded (upper case) name is kept once
+ * and gets a compact id, given in order of first REGISTER. ids are never
+ * reused, so a client that registers again gets its old id back and an id
+ * held by an event always names the same client. the registry and the
+ * events keep ids only, the names are looked up by id without a lock - an
+ * interned name never moves. names are not reclaimed on UNREGISTER, as a
+ * guests list being read may still hold the id (reclaiming would need the
+ * readers to be tracked), so the table is bounded instead: once it holds
+ * MAX_NAME_CHUNKS * NAME_CHUNK_LEN names, a new name is refused.
+ */
+class NameTable
+{
+public:
+
+    NameTable();
+
+    /**
+     * destructor - frees the id -> name table.
+     */
+    virtual ~NameTable();
+
+    NameTable( NameTable const &other) = delete;
+    void operator=( NameTable const &other) = delete;
+
+    /**
+     * @brief: intern the (case insensitive) name.
+     * @return: the id of the name - a new one if it is new, or NO_NAME if
+     * it is new and the table is full.
+     */
+    NameId intern( const std::string& name);
+
+    /**
+     * @return: the id of the (case insensitive) name, or NO_NAME if it was
+     * never interned.
+     */
+    NameId find( const std::string& name);
+
+    /**
+     * @return: the (upper case) name of an interned id - no lock is taken.
+     */
+    const std::string& name( NameId id) const {
+        return *_chunks[id / NAME_CHUNK_LEN][id % NAME_CHUNK_LEN];
+    }
+
+private:
+
+    typedef std::unordered_map<std::string, NameId, CaseInsensitiveHash,
+                               CaseInsensitiveEqual> IdMap;
+
+    RWLock _lock;
+    IdMap _ids; /* looked up by the name as given - no upper case copy */
+    /* id -> its name, the key of its _ids node (node keys never move). the
+     * chunks never move either, so a name is read while others are added */
+    const std::string** _chunks[MAX_NAME_CHUNKS];
+    NameId _count; /* names interned */
+};
+
+#endif /* NAMETABLE_H_ */
@@ -0,0 +1,97 @@
+/*
+ * RWLock.h
+ * Created on: Oct 17, 2026
+ * Author: nicole
+ */
+
+#ifndef RWLOCK_H_
+#define RWLOCK_H_
+
+#include <pthread.h>
+
+
+/**
+ * A reader/writer lock - many readers or one writer. c++11 has no
+ * std::shared_mutex, so this wraps a pthread rwlock.
+ */
+class RWLock
+{
+public:
+
+    RWLock() {
+        pthread_rwlock_init( &_lock, NULL);
+    }
+
+    virtual ~RWLock() {
+        pthread_rwlock_destroy( &_lock);
+    }
+
+    RWLock( RWLock const &other) = delete;
+    void operator=( RWLock const &other) = delete;
+
+    void lockRead() {
+        pthread_rwlock_rdlock( &_lock);
+    }
+
+    void lockWrite() {
+        pthread_rwlock_wrlock( &_lock);
+    }
+
+    void unlock() {
+        pthread_rwlock_unlock( &_lock);
+    }
+
+private:
+
+    pthread_rwlock_t _lock;
+};
+
+
+/**
+ * holds the read side of a RWLock for the lifetime of the guard.
+ */
+class ReadGuard
+{
+public:
+
+    ReadGuard( RWLock& lock): _lock( lock) {
+        _lock.lockRead();
+    }
+
+    ~ReadGuard() {
+        _lock.unlock();
+    }
+
+    ReadGuard( ReadGuard const &other) = delete;
+    void operator=( ReadGuard const &other) = delete;
+
+private:
+
+    RWLock& _lock;
+};
+
+
+/**
+ * holds the write side of a RWLock for the lifetime of the guard.
+ */
+class WriteGuard
+{
+public:
+
+    WriteGuard( RWLock& lock): _lock( lock) {
+        _lock.lockWrite();
+    }
+
+    ~WriteGuard() {
+        _lock.unlock();
+    }
+
+    WriteGuard( WriteGuard const &other) = delete;
+    void operator=( WriteGuard const &other) = delete;
+
+private:
+
+    RWLock& _lock;
+};
+
+#endif /* RWLOCK_H_ */
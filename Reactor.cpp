@@ -0,0 +1,412 @@
+/*
+ * Reactor.cpp
+ * Created on: Oct 17, 2026
+ * Author: nicole
+ */
+
+#include "Reactor.h"
+
+/*************** Public Functions **************************************/
+
+/**
+ * @brief: Constructor - takes the (already listening) master socket and
+ * the pool that executes the commands.
+ */
+Reactor::Reactor( int listenSock, ThreadPool* pool): _listenSock( listenSock),
+        _wakeFD( -1), _running( true), _pool( pool)
+{
+    _wakeFD = eventfd( 0, EFD_NONBLOCK);
+    if ( _wakeFD < 0) {
+        Server::logServerError( "eventfd", std::to_string( errno));
+    }
+}
+
+
+/**
+ * destructor - closes all open client connections.
+ */
+Reactor::~Reactor()
+{
+    std::map<int, Connection*>::iterator it;
+    std::set<Connection*>::iterator closedIt;
+
+    /* the pool is destroyed first, so no job refers to a connection now */
+    for ( it = _connections.begin(); it != _connections.end(); ++it) {
+        close( it->first);
+        delete it->second;
+    }
+    _connections.clear();
+
+    /* connections that were closed while a job or I/O still referred to
+     * them - the responses left in _done belong to them */
+    for ( closedIt = _closed.begin(); closedIt != _closed.end(); ++closedIt) {
+        close( (*closedIt)->sock);
+        delete *closedIt;
+    }
+    _closed.clear();
+    _done.clear();
+
+    if ( _wakeFD >= 0) {
+        close( _wakeFD);
+    }
+}
+
+/**
+ * @brief: make the event loop return - may be called from any thread.
+ */
+void Reactor::stop()
+{
+    uint64_t one = 1;
+
+    _running = false;
+    if ( write( _wakeFD, &one, sizeof(one)) < 0 && errno != EAGAIN) {
+        Server::logServerError( "write", std::to_string( errno));
+    }
+}
+
+/*************** Protected Functions **************************************/
+
+/**
+ * @brief: create the state of a newly accepted client socket.
+ */
+Reactor::Connection* Reactor::_createConnection( int sock)
+{
+    return new Connection( sock);
+}
+
+
+/**
+ * @return: true if the engine has no I/O in flight on the connection.
+ */
+bool Reactor::_released( Connection* conn)
+{
+    return true;
+}
+
+
+/**
+ * @brief: stop the engine reads of a connection that is being paused - an
+ * engine that reads on demand just stops reading it.
+ */
+void Reactor::_pauseInput( Connection* conn)
+{}
+
+
+/**
+ * @brief: start tracking a newly accepted client socket.
+ */
+Reactor::Connection* Reactor::_addConnection( int sock)
+{
+    Connection* conn = _createConnection( sock);
+
+    _connections[sock] = conn;
+    return conn;
+}
+
+
+/**
+ * @brief: new bytes were read into the connection reader (or the peer
+ * closed its side) - handle the complete requests and write back.
+ */
+void Reactor::_inputReceived( Connection* conn)
+{
+    /* binary frames are checked by their length header */
+    if ( !conn->binary && conn->reader.overflow()) {
+        Server::logServerError( "read", "request line is too long");
+        _closeConnection( conn);
+        return;
+    }
+
+    _handleRequest( conn);
+    _writeConnection( conn); /* may close the connection */
+}
+
+
+/**
+ * @brief: all the pending response bytes were written - close the
+ * connection if there is nothing more to wait for.
+ */
+void Reactor::_writeDone( Connection* conn)
+{
+    /* a paused connection still has requests to run once it resumes */
+    if ( conn->closing ||
+         (conn->peerClosed && !conn->busy && !conn->paused)) {
+        _closeConnection( conn);
+    }
+}
+
+
+/**
+ * @return: true if conn has too many requests waiting in its reader, or
+ * responses waiting to be written, to take more. a pipelining client that
+ * does not read its responses is then held back by the TCP window instead
+ * of growing the buffers.
+ */
+bool Reactor::_backlogged( Connection* conn) const
+{
+    return conn->reader.available() >= MAX_INPUT_BACKLOG ||
+           conn->out.size() >= MAX_OUTPUT_BACKLOG;
+}
+
+
+/**
+ * @brief: stop reading from conn (and handing its requests to the pool)
+ * until its backlog drains.
+ */
+void Reactor::_pause( Connection* conn)
+{
+    if ( conn->paused) {
+        return;
+    }
+    conn->paused = true;
+    _paused.insert( conn);
+    _pauseInput( conn);
+}
+
+
+/**
+ * @brief: resume the paused connections whose backlog drained - called by
+ * the engine once per loop iteration, after the writes and the responses
+ * of the iteration. a connection whose responses drained but whose reader
+ * is still full stays paused, and only runs the requests already read.
+ */
+void Reactor::_resumeDrained()
+{
+    std::vector<Connection*> drained;
+    std::vector<Connection*>::iterator it;
+    std::set<Connection*>::iterator pausedIt;
+    Connection* conn;
+
+    for ( pausedIt = _paused.begin(); pausedIt != _paused.end(); ++pausedIt)
+    {
+        conn = *pausedIt;
+        if ( !_backlogged( conn) ||
+             (!conn->busy && conn->out.size() < MAX_OUTPUT_BACKLOG)) {
+            drained.push_back( conn);
+        }
+    }
+
+    for ( it = drained.begin(); it != drained.end(); ++it)
+    {
+        conn = *it;
+        if ( _backlogged( conn)) {
+            _inputReceived( conn); /* may close the connection */
+            continue;
+        }
+        _paused.erase( conn);
+        conn->paused = false;
+        _resumeInput( conn); /* may close the connection */
+    }
+}
+
+
+/**
+ * @brief: close the client connection. the state is freed once no job
+ * and no engine I/O refers to it.
+ */
+void Reactor::_closeConnection( Connection* conn)
+{
+    _connections.erase( conn->sock);
+    _closed.insert( conn);
+    _paused.erase( conn);
+    conn->dead = true;
+
+    /* the socket (and its fd number) is kept until the state is freed */
+    _detachConnection( conn);
+    _freeConnection( conn);
+}
+
+
+/**
+ * @brief: free a closed connection if nothing refers to it anymore.
+ */
+void Reactor::_freeConnection( Connection* conn)
+{
+    if ( conn->busy || !_released( conn)) {
+        return;
+    }
+
+    _closed.erase( conn);
+    close( conn->sock);
+    delete conn;
+}
+
+
+/**
+ * @brief: take the next complete line out of the connection reader.
+ * once the peer closed the connection the rest of the buffer is a line.
+ * @return: false if there is no complete line yet.
+ */
+bool Reactor::_nextLine( Connection* conn, std::string& line)
+{
+    return conn->reader.nextLine( line, conn->peerClosed);
+}
+
+
+/**
+ * @brief: pass the complete requests in conn input buffer to the server
+ * on the worker pool. a plain connection carries one request:
+ * <client name>\n<command line>\n, a session connection starts with
+ * SESSION <client name>\n followed by any number of command lines. a
+ * pipelining client may send many lines without waiting - all the lines
+ * already received run in one job, in order, so the responses are written
+ * back in request order.
+ */
+void Reactor::_handleRequest( Connection* conn)
+{
+    std::string line;
+
+    if ( conn->busy || conn->closing) {
+        return;
+    }
+    if ( conn->out.size() >= MAX_OUTPUT_BACKLOG) {
+        _pause( conn); /* the client is not reading its responses */
+        return;
+    }
+
+    if ( !conn->named) {
+        if ( !_nextLine( conn, line)) {
+            return;
+        }
+        conn->named = true;
+        if ( CommandParser::isSessionRequest( line, conn->client)) {
+            conn->session = true;
+        } else if ( CommandParser::isBinarySessionRequest( line,
+                                                           conn->client)) {
+            conn->session = true;
+            conn->binary = true;
+        } else {
+            conn->client = line;
+        }
+    }
+
+    if ( conn->binary) {
+        _handleBinaryRequests( conn);
+        return;
+    }
+
+    /* handed to the job by pointer - a captured vector copies every line */
+    std::shared_ptr<std::vector<std::string> > lines =
+            std::make_shared<std::vector<std::string> >();
+    while ( (conn->session || lines->empty()) &&
+            lines->size() < MAX_PIPELINE_BATCH && _nextLine( conn, line)) {
+        lines->push_back( std::move( line));
+    }
+    if ( lines->empty()) {
+        return; /* wait for the command line */
+    }
+
+    conn->busy = true;
+    _pool->submit( [this, conn, lines] {
+        Server& server = Server::getInstance();
+        ResponseQueue responses;
+        std::vector<std::string>::const_iterator it;
+
+        if ( !conn->session) {
+            responses.push( server.parseCommand( conn->client,
+                                                 lines->front()));
+        } else {
+            for ( it = lines->begin(); it != lines->end(); ++it) {
+                responses.pushFramed( server.parseCommand( conn->client, *it));
+            }
+        }
+        _postResponse( conn, std::move( responses));
+    });
+}
+
+
+/**
+ * @brief: pass the complete binary request frames in conn input buffer to
+ * the server on the worker pool - in order, like pipelined text commands.
+ */
+void Reactor::_handleBinaryRequests( Connection* conn)
+{
+    typedef std::vector<std::pair<BinaryHeader, std::string> > Frames;
+    BinaryHeader header;
+    std::string payload;
+    /* handed to the job by pointer, as the text lines are */
+    std::shared_ptr<Frames> frames = std::make_shared<Frames>();
+    int res = 0;
+
+    while ( frames->size() < MAX_PIPELINE_BATCH &&
+            (res = BinaryProtocol::takeFrame( conn->reader, header,
+                                              payload)) == 1) {
+        frames->push_back( std::make_pair( header, std::move( payload)));
+    }
+
+    if ( frames->empty()) {
+        if ( res < 0) {
+            Server::logServerError( "read", "binary frame is too long");
+            conn->closing = true; /* nothing is pending - close on write */
+        }
+        return;
+    }
+
+    conn->busy = true;
+    _pool->submit( [this, conn, frames] {
+        Server& server = Server::getInstance();
+        ResponseQueue responses;
+        Frames::const_iterator it;
+
+        for ( it = frames->begin(); it != frames->end(); ++it) {
+            server.executeBinary( conn->client, it->first, it->second,
+                                  responses);
+        }
+        _postResponse( conn, std::move( responses));
+    });
+}
+
+
+/**
+ * @brief: worker side - post the response (or the framed responses of a
+ * session batch) of conn and wake the loop.
+ */
+void Reactor::_postResponse( Connection* conn, ResponseQueue responses)
+{
+    uint64_t one = 1;
+
+    {
+        std::lock_guard<std::mutex> guard( _doneLock);
+        _done.push_back( std::make_pair( conn, std::move( responses)));
+    }
+
+    if ( write( _wakeFD, &one, sizeof(one)) < 0 && errno != EAGAIN) {
+        Server::logServerError( "write", std::to_string( errno));
+    }
+}
+
+
+/**
+ * @brief: loop side - queue the responses posted by the workers.
+ */
+void Reactor::_collectResponses()
+{
+    std::vector<std::pair<Connection*, ResponseQueue> > done;
+    std::vector<std::pair<Connection*, ResponseQueue> >::iterator it;
+    Connection* conn;
+
+    {
+        std::lock_guard<std::mutex> guard( _doneLock);
+        done.swap( _done);
+    }
+
+    for ( it = done.begin(); it != done.end(); ++it)
+    {
+        conn = it->first;
+        conn->busy = false;
+
+        if ( conn->dead) {
+            _freeConnection( conn);
+            continue;
+        }
+
+        /* the segments are moved over - the payloads are not copied */
+        conn->out.splice( it->second);
+        if ( conn->session) {
+            _handleRequest( conn); /* next commands of the session */
+        } else {
+            conn->closing = true;
+        }
+        _writeConnection( conn);
+    }
+}
@@ -0,0 +1,224 @@
+/*
+ * Reactor.h
+ * Created on: Oct 17, 2026
+ * Author: nicole
+ */
+
+#ifndef REACTOR_H_
+#define REACTOR_H_
+
+#include <stdio.h>
+#include <unistd.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <string>
+#include <string.h>
+#include <map>
+#include <atomic>
+#include <set>
+#include <vector>
+#include <mutex>
+#include <memory> // shared_ptr
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+
+#include "Server.h"
+#include "ThreadPool.h"
+#include "ResponseQueue.h"
+
+/* max number of pipelined commands of one connection run in one job */
+#define MAX_PIPELINE_BATCH 64
+/* a connection stops reading once this many request bytes wait in its
+ * reader (room for a few of the longest requests) ... */
+#define MAX_INPUT_BACKLOG (4 * MAX_REQUEST_LEN)
+/* ... or this many responses wait to be written, until they drain */
+#define MAX_OUTPUT_BACKLOG 256
+
+
+/**
+ * The engine neutral part of the server event loop. The reactor owns the
+ * listening socket and all the client connections, assembles each request
+ * incrementally, hands it to Server::parseCommand on the worker pool and
+ * queues back the response without blocking on any single client. a session
+ * connection stays open and carries many commands. the I/O itself - how
+ * bytes are read, written and waited for - is done by the engine subclass
+ * (EpollReactor, UringReactor).
+ */
+class Reactor
+{
+public:
+
+    /**
+     * @brief: Constructor - takes the (already listening) master socket and
+     * the pool that executes the commands.
+     */
+    Reactor( int listenSock, ThreadPool* pool);
+
+    /**
+     * destructor - closes all open client connections.
+     */
+    virtual ~Reactor();
+
+    /**
+     * @brief: set up the engine resources.
+     * @return: false if the engine can not run on this system.
+     */
+    virtual bool init() = 0;
+
+    /**
+     * @brief: run the event loop until stop is called.
+     */
+    virtual void run() = 0;
+
+    /**
+     * @brief: make the event loop return - may be called from any thread.
+     */
+    void stop();
+
+protected:
+
+    /**
+     * state of one client connection.
+     */
+    struct Connection
+    {
+        int sock;
+        RequestReader reader; /* pooled buffer of the bytes read so far */
+        ResponseQueue out;  /* responses not written yet */
+        bool closing;       /* close connection once out is flushed */
+        bool busy;          /* a command of this connection is on the pool */
+        bool dead;          /* closed - free when nothing refers to it */
+        bool named;         /* the client name line was received */
+        bool session;       /* persistent connection of many commands */
+        bool binary;        /* session of the binary protocol */
+        bool peerClosed;    /* client closed its side of the connection */
+        bool paused;        /* reading stopped until the backlog drains */
+        std::string client; /* the client name */
+
+        Connection( int sockFD): sock( sockFD), closing( false),
+                busy( false), dead( false), named( false), session( false),
+                binary( false), peerClosed( false), paused( false)
+        {}
+
+        virtual ~Connection()
+        {}
+    };
+
+    int _listenSock;
+    int _wakeFD;  /* eventfd the workers signal when a response is ready */
+    std::atomic<bool> _running; /* cleared by stop */
+    ThreadPool* _pool;
+    std::map<int /*socket*/, Connection*> _connections;
+    std::set<Connection*> _closed; /* closed, but still referred to */
+    std::set<Connection*> _paused; /* reading stopped by their backlog */
+    std::mutex _doneLock;
+    std::vector<std::pair<Connection*, ResponseQueue> > _done; /* responses */
+
+    /**
+     * @brief: create the state of a newly accepted client socket.
+     */
+    virtual Connection* _createConnection( int sock);
+
+    /**
+     * @brief: write as much of the pending response as the engine can.
+     */
+    virtual void _writeConnection( Connection* conn) = 0;
+
+    /**
+     * @brief: stop the engine I/O on the connection that is being closed.
+     */
+    virtual void _detachConnection( Connection* conn) = 0;
+
+    /**
+     * @return: true if the engine has no I/O in flight on the connection.
+     */
+    virtual bool _released( Connection* conn);
+
+    /**
+     * @brief: stop the engine reads of a connection that is being paused.
+     */
+    virtual void _pauseInput( Connection* conn);
+
+    /**
+     * @brief: start reading again from a paused connection whose backlog
+     * drained, and handle the requests already read.
+     */
+    virtual void _resumeInput( Connection* conn) = 0;
+
+    /**
+     * @brief: start tracking a newly accepted client socket.
+     */
+    Connection* _addConnection( int sock);
+
+    /**
+     * @brief: new bytes were read into the connection reader (or the peer
+     * closed its side) - handle the complete requests and write back.
+     */
+    void _inputReceived( Connection* conn);
+
+    /**
+     * @brief: all the pending response bytes were written - close the
+     * connection if there is nothing more to wait for.
+     */
+    void _writeDone( Connection* conn);
+
+    /**
+     * @return: true if conn has too many requests waiting in its reader, or
+     * responses waiting to be written, to take more.
+     */
+    bool _backlogged( Connection* conn) const;
+
+    /**
+     * @brief: stop reading from conn (and handing its requests to the pool)
+     * until its backlog drains.
+     */
+    void _pause( Connection* conn);
+
+    /**
+     * @brief: resume the paused connections whose backlog drained - called
+     * by the engine once per loop iteration.
+     */
+    void _resumeDrained();
+
+    /**
+     * @brief: close the client connection. the state is freed once no job
+     * and no engine I/O refers to it.
+     */
+    void _closeConnection( Connection* conn);
+
+    /**
+     * @brief: free a closed connection if nothing refers to it anymore.
+     */
+    void _freeConnection( Connection* conn);
+
+    /**
+     * @brief: take the next complete line out of the connection reader.
+     * @return: false if there is no complete line yet.
+     */
+    bool _nextLine( Connection* conn, std::string& line);
+
+    /**
+     * @brief: pass the complete requests in conn input buffer to the
+     * server on the worker pool - pipelined requests run in order.
+     */
+    void _handleRequest( Connection* conn);
+
+    /**
+     * @brief: pass the complete binary request frames in conn input buffer
+     * to the server on the worker pool.
+     */
+    void _handleBinaryRequests( Connection* conn);
+
+    /**
+     * @brief: worker side - post the response of conn and wake the loop.
+     */
+    void _postResponse( Connection* conn, ResponseQueue responses);
+
+    /**
+     * @brief: loop side - queue the responses posted by the workers.
+     */
+    void _collectResponses();
+};
+
+#endif /* REACTOR_H_ */
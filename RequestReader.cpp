@@ -0,0 +1,200 @@
+/*
+ * RequestReader.cpp
+ * Created on: Oct 17, 2026
+ * Author: nicole
+ */
+
+#include "RequestReader.h"
+
+/*************** BufferPool **************************************/
+
+BufferPool::BufferPool()
+{}
+
+
+BufferPool::~BufferPool()
+{
+    std::vector<Buffer*>::iterator it;
+
+    for ( it = _free.begin(); it != _free.end(); ++it) {
+        delete *it;
+    }
+    _free.clear();
+}
+
+
+/**
+ * @brief: public getter - gets the singleton instance each call.
+ */
+BufferPool& BufferPool::getInstance()
+{
+    static BufferPool pool;
+    return pool;
+}
+
+
+/**
+ * @brief: take a free buffer from the pool (or a new one if empty).
+ */
+BufferPool::Buffer* BufferPool::acquire()
+{
+    Buffer* buf;
+
+    {
+        std::lock_guard<std::mutex> guard( _lock);
+        if ( !_free.empty()) {
+            buf = _free.back();
+            _free.pop_back();
+            return buf;
+        }
+    }
+
+    buf = new Buffer( READ_CHUNK);
+    return buf;
+}
+
+
+/**
+ * @brief: return a buffer to the pool. a buffer that grew because of a long
+ * request is shrunk back so the pool memory stays bounded.
+ */
+void BufferPool::release( Buffer* buf)
+{
+    if ( buf->size() > READ_CHUNK) {
+        Buffer( READ_CHUNK).swap( *buf);
+    }
+
+    {
+        std::lock_guard<std::mutex> guard( _lock);
+        if ( _free.size() < MAX_POOLED_BUFFERS) {
+            _free.push_back( buf);
+            return;
+        }
+    }
+
+    delete buf;
+}
+
+/*************** RequestReader **************************************/
+
+RequestReader::RequestReader(): _buf( BufferPool::getInstance().acquire()),
+        _start( 0), _end( 0)
+{}
+
+
+RequestReader::~RequestReader()
+{
+    BufferPool::getInstance().release( _buf);
+}
+
+
+/**
+ * @brief: one read call from sock into the free space of the buffer.
+ * @return: the read call result - bytes read, 0 on EOF or -1 on error.
+ */
+ssize_t RequestReader::fill( int sock)
+{
+    ssize_t numRead;
+
+    _reserve( READ_CHUNK);
+    numRead = read( sock, _buf->data() + _end, _buf->size() - _end);
+    if ( numRead > 0) {
+        _end += numRead;
+    }
+    return numRead;
+}
+
+
+/**
+ * @brief: append n bytes that were already read (by an asynchronous
+ * engine) to the buffer.
+ */
+void RequestReader::append( const char* data, size_t n)
+{
+    _reserve( n);
+    memcpy( _buf->data() + _end, data, n);
+    _end += n;
+}
+
+
+/**
+ * @brief: take the next complete line (without the new line) out of the
+ * buffer. when atEOF the rest of the buffer is the last line.
+ * @return: false if there is no complete line yet.
+ */
+bool RequestReader::nextLine( std::string& line, bool atEOF)
+{
+    const char* begin = _buf->data() + _start;
+    const char* newLine;
+    size_t length;
+
+    if ( _start == _end) {
+        return false;
+    }
+
+    newLine = (const char*) memchr( begin, '\n', _end - _start);
+    if ( newLine == NULL) {
+        if ( !atEOF) {
+            return false;
+        }
+        line.assign( begin, _end - _start);
+        _start = _end = 0;
+        return true;
+    }
+
+    length = newLine - begin;
+    line.assign( begin, length);
+    _start += length + 1;
+    if ( _start == _end) {
+        _start = _end = 0;
+    }
+    return true;
+}
+
+
+/**
+ * @return: true if the next buffered line is still incomplete and
+ * already longer than MAX_REQUEST_LEN.
+ */
+bool RequestReader::overflow() const
+{
+    return _end - _start > MAX_REQUEST_LEN &&
+           memchr( _buf->data() + _start, '\n', MAX_REQUEST_LEN) == NULL;
+}
+
+
+/**
+ * @brief: mark the first n unread bytes as read.
+ */
+void RequestReader::consume( size_t n)
+{
+    _start += n;
+    if ( _start >= _end) {
+        _start = _end = 0;
+    }
+}
+
+/*************** Private Functions **************************************/
+
+/**
+ * @brief: make room for at least n more bytes after the read bytes.
+ */
+void RequestReader::_reserve( size_t n)
+{
+    size_t size;
+
+    /* move the unread bytes to the front before growing the buffer */
+    if ( _start > 0 && _buf->size() - _end < n) {
+        memmove( _buf->data(), _buf->data() + _start, _end - _start);
+        _end -= _start;
+        _start = 0;
+    }
+
+    size = _buf->size();
+    while ( size - _end < n) {
+        size *= 2;
+    }
+    if ( size != _buf->size()) {
+        _buf->resize( size);
+    }
+}
@@ -0,0 +1,140 @@
+/*
+ * RequestReader.h
+ * Created on: Oct 17, 2026
+ * Author: nicole
+ */
+
+#ifndef REQUESTREADER_H_
+#define REQUESTREADER_H_
+
+#include <unistd.h>
+#include <errno.h>
+#include <string>
+#include <string.h>
+#include <vector>
+#include <mutex>
+#include <sys/types.h> // for size_t, ssize_t
+
+/* size of the chunk read from a client socket in each read call */
+#define READ_CHUNK 4096
+/* longest request line - a longer line is a protocol error */
+#define MAX_REQUEST_LEN 65536
+/* max number of free buffers kept by the pool */
+#define MAX_POOLED_BUFFERS 1024
+
+
+/**
+ * A singleton pool of reusable read buffers. A connection takes a buffer when
+ * it is opened and returns it when it is closed, so the buffers (and their
+ * grown capacity) are reused between connections instead of being allocated
+ * for each one.
+ */
+class BufferPool
+{
+public:
+
+    typedef std::vector<char> Buffer;
+
+    BufferPool( BufferPool const &other) = delete;
+    void operator=( BufferPool const &other) = delete;
+
+    /**
+     * @brief: public getter - gets the singleton instance each call.
+     */
+    static BufferPool& getInstance();
+
+    /**
+     * @brief: take a free buffer from the pool (or a new one if empty).
+     */
+    Buffer* acquire();
+
+    /**
+     * @brief: return a buffer to the pool.
+     */
+    void release( Buffer* buf);
+
+private:
+
+    std::mutex _lock;
+    std::vector<Buffer*> _free;
+
+    BufferPool();
+    virtual ~BufferPool();
+};
+
+
+/**
+ * An incremental reader of newline delimited requests from a socket. Bytes
+ * are read straight into a pooled growable buffer, so a request that arrives
+ * in several short reads is assembled and several requests that arrive in
+ * one read (coalesced) are returned one by one. binary frames are taken
+ * with peek and consume.
+ */
+class RequestReader
+{
+public:
+
+    RequestReader();
+
+    virtual ~RequestReader();
+
+    RequestReader( RequestReader const &other) = delete;
+    void operator=( RequestReader const &other) = delete;
+
+    /**
+     * @brief: one read call from sock into the free space of the buffer.
+     * @return: the read call result - bytes read, 0 on EOF or -1 on error.
+     */
+    ssize_t fill( int sock);
+
+    /**
+     * @brief: append n bytes that were already read (by an asynchronous
+     * engine) to the buffer.
+     */
+    void append( const char* data, size_t n);
+
+    /**
+     * @brief: take the next complete line (without the new line) out of the
+     * buffer. when atEOF the rest of the buffer is the last line.
+     * @return: false if there is no complete line yet.
+     */
+    bool nextLine( std::string& line, bool atEOF = false);
+
+    /**
+     * @return: true if the next buffered line is still incomplete and
+     * already longer than MAX_REQUEST_LEN.
+     */
+    bool overflow() const;
+
+    /**
+     * @return: the unread bytes.
+     */
+    const char* peek() const {
+        return _buf->data() + _start;
+    }
+
+    /**
+     * @return: number of unread bytes.
+     */
+    size_t available() const {
+        return _end - _start;
+    }
+
+    /**
+     * @brief: mark the first n unread bytes as read.
+     */
+    void consume( size_t n);
+
+private:
+
+    BufferPool::Buffer* _buf;
+    size_t _start;  /* first unread byte */
+    size_t _end;    /* end of the bytes read */
+
+    /**
+     * @brief: make room for at least n more bytes after the read bytes.
+     */
+    void _reserve( size_t n);
+};
+
+#endif /* REQUESTREADER_H_ */
@@ -0,0 +1,159 @@
+/*
+ * ResponseCache.cpp
+ * Created on: Oct 17, 2026
+ * Author: nicole
+ */
+
+#include "ResponseCache.h"
+
+std::atomic<uint64_t> ResponseCache::_hits( 0);
+std::atomic<uint64_t> ResponseCache::_misses( 0);
+
+
+ResponseCache::ResponseCache()
+{}
+
+
+ResponseCache::~ResponseCache()
+{}
+
+
+/**
+ * @return: the cached bytes if they were built from version, otherwise
+ * null (a miss).
+ */
+std::shared_ptr<const std::string> ResponseCache::get( uint64_t version)
+{
+    std::shared_ptr<const Entry> entry = std::atomic_load( &_entry);
+
+    if ( entry == nullptr || entry->version != version) {
+        _misses.fetch_add( 1, std::memory_order_relaxed);
+        return nullptr;
+    }
+    _hits.fetch_add( 1, std::memory_order_relaxed);
+    /* aliasing constructor - shares the ownership of the whole entry */
+    return std::shared_ptr<const std::string>( entry, &entry->text);
+}
+
+
+/**
+ * @brief: cache text as the bytes of version. readers that missed at once
+ * may all put - the last one stays, even if it is not the newest version,
+ * and the next reader of another version just misses.
+ * @return: the cached bytes.
+ */
+std::shared_ptr<const std::string> ResponseCache::put( uint64_t version,
+                                                       std::string text)
+{
+    std::shared_ptr<Entry> entry = std::make_shared<Entry>();
+
+    entry->version = version;
+    entry->text.swap( text);
+    entry->count = 0;
+    std::atomic_store( &_entry, std::shared_ptr<const Entry>( entry));
+    return std::shared_ptr<const std::string>( entry, &entry->text);
+}
+
+
+/**
+ * @return: the cached bytes if they were built from version and hold the
+ * last count records, otherwise null (a miss). bytes built for fewer
+ * records than asked hold all the records there are - of the same version
+ * there are no more. offset is set to the first byte of those records.
+ */
+std::shared_ptr<const std::string> ResponseCache::getTail( uint64_t version,
+                                                           size_t count,
+                                                           size_t& offset)
+{
+    std::shared_ptr<const Entry> entry = std::atomic_load( &_entry);
+
+    if ( entry == nullptr || entry->version != version ||
+         (count > entry->count && entry->records.size() == entry->count)) {
+        _misses.fetch_add( 1, std::memory_order_relaxed);
+        return nullptr;
+    }
+    _hits.fetch_add( 1, std::memory_order_relaxed);
+    offset = tailOffset( entry->records, count);
+    return std::shared_ptr<const std::string>( entry, &entry->text);
+}
+
+
+/**
+ * @brief: cache text as the bytes of version - the last count records,
+ * oldest first, each starting at its offset in records (fewer records if
+ * there are no more). bytes of a newer version, or of the same version
+ * built for a larger count, stay cached - a racing read does not replace
+ * them.
+ * @return: the bytes of text.
+ */
+std::shared_ptr<const std::string> ResponseCache::putTail( uint64_t version,
+                                                  std::string text,
+                                                  std::vector<size_t> records,
+                                                  size_t count)
+{
+    std::shared_ptr<Entry> entry = std::make_shared<Entry>();
+    std::shared_ptr<const Entry> cached = std::atomic_load( &_entry);
+
+    entry->version = version;
+    entry->text.swap( text);
+    entry->records.swap( records);
+    entry->count = count;
+    while ( cached == nullptr || cached->version < version ||
+            (cached->version == version && cached->count < count)) {
+        if ( std::atomic_compare_exchange_weak( &_entry, &cached,
+                                std::shared_ptr<const Entry>( entry))) {
+            break;
+        }
+    }
+    return std::shared_ptr<const std::string>( entry, &entry->text);
+}
+
+
+/**
+ * @return: the offset of the last count records, given the offset of each
+ * record - 0 if there are no more than count.
+ */
+size_t ResponseCache::tailOffset( const std::vector<size_t>& records,
+                                  size_t count)
+{
+    if ( count >= records.size()) {
+        return 0;
+    }
+    return records[records.size() - count];
+}
+
+
+/**
+ * @brief: drop the cached bytes.
+ */
+void ResponseCache::reset()
+{
+    std::atomic_store( &_entry, std::shared_ptr<const Entry>());
+}
+
+
+/**
+ * @return: bytes held by the cached entry - its text and record offsets -
+ * 0 if there is none. a replaced entry still held by a reader is not
+ * counted.
+ */
+size_t ResponseCache::memoryUsage()
+{
+    std::shared_ptr<const Entry> entry = std::atomic_load( &_entry);
+
+    if ( entry == nullptr) {
+        return 0;
+    }
+    return sizeof( Entry) + entry->text.capacity() +
+           entry->records.capacity() * sizeof( size_t);
+}
+
+
+/**
+ * @return: "cache hits <n> misses <n>" - of all the caches.
+ */
+std::string ResponseCache::stats()
+{
+    return "cache hits " + std::to_string( _hits.load()) + " misses " +
+           std::to_string( _misses.load());
+}
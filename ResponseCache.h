@@ -0,0 +1,112 @@
+/*
+ * ResponseCache.h
+ * Created on: Oct 17, 2026
+ * Author: nicole
+ */
+
+#ifndef RESPONSECACHE_H_
+#define RESPONSECACHE_H_
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <atomic>
+#include <memory> // shared_ptr, atomic_load, atomic_store
+
+
+/**
+ * The serialized bytes of one read response, cached with the version of
+ * the data they were built from. A reader that sees the version unchanged
+ * takes the cached bytes as a shared pointer - no rebuild and no copy;
+ * the data writers bump the version, so the next read rebuilds. the entry
+ * is replaced atomically and never changed, so readers take no lock. hits
+ * and misses of all the caches are counted together. bytes made of records
+ * can be cached with the record offsets, so a read of fewer records takes
+ * the tail of the cached bytes.
+ */
+class ResponseCache
+{
+public:
+
+    ResponseCache();
+
+    virtual ~ResponseCache();
+
+    ResponseCache( ResponseCache const &other) = delete;
+    void operator=( ResponseCache const &other) = delete;
+
+    /**
+     * @return: the cached bytes if they were built from version, otherwise
+     * null (a miss).
+     */
+    std::shared_ptr<const std::string> get( uint64_t version);
+
+    /**
+     * @brief: cache text as the bytes of version.
+     * @return: the cached bytes.
+     */
+    std::shared_ptr<const std::string> put( uint64_t version,
+                                            std::string text);
+
+    /**
+     * @return: the cached bytes if they were built from version and hold the
+     * last count records, otherwise null (a miss). offset is set to the
+     * first byte of those records.
+     */
+    std::shared_ptr<const std::string> getTail( uint64_t version,
+                                                size_t count, size_t& offset);
+
+    /**
+     * @brief: cache text as the bytes of version - the last count records,
+     * oldest first, each starting at its offset in records (fewer records
+     * if there are no more) - unless bytes of a newer version, or of
+     * version for a larger count, are cached.
+     * @return: the bytes of text.
+     */
+    std::shared_ptr<const std::string> putTail( uint64_t version,
+                                                std::string text,
+                                                std::vector<size_t> records,
+                                                size_t count);
+
+    /**
+     * @return: the offset of the last count records, given the offset of
+     * each record.
+     */
+    static size_t tailOffset( const std::vector<size_t>& records,
+                              size_t count);
+
+    /**
+     * @brief: drop the cached bytes.
+     */
+    void reset();
+
+    /**
+     * @return: bytes held by the cached entry, 0 if there is none.
+     */
+    size_t memoryUsage();
+
+    /**
+     * @return: "cache hits <n> misses <n>" - of all the caches.
+     */
+    static std::string stats();
+
+private:
+
+    /**
+     * immutable cached response - replaced, never changed.
+     */
+    struct Entry
+    {
+        uint64_t version;
+        std::string text;
+        std::vector<size_t> records; /* offset of each record in text */
+        size_t count; /* records asked for - more than records if fewer */
+    };
+
+    std::shared_ptr<const Entry> _entry; /* accessed atomically only */
+
+    static std::atomic<uint64_t> _hits;
+    static std::atomic<uint64_t> _misses;
+};
+
+#endif /* RESPONSECACHE_H_ */
@@ -0,0 +1,301 @@
+/*
+ * ResponseQueue.cpp
+ * Created on: Oct 17, 2026
+ * Author: nicole
+ */
+
+#include "ResponseQueue.h"
+
+/*************** SegmentPool **************************************/
+
+SegmentPool::SegmentPool()
+{}
+
+
+SegmentPool::~SegmentPool()
+{
+    std::vector<ResponseSegment*>::iterator it;
+
+    for ( it = _free.begin(); it != _free.end(); ++it) {
+        delete *it;
+    }
+    _free.clear();
+}
+
+
+/**
+ * @brief: public getter - gets the singleton instance each call.
+ */
+SegmentPool& SegmentPool::getInstance()
+{
+    static SegmentPool pool;
+    return pool;
+}
+
+
+/**
+ * @brief: take a free segment from the pool (or a new one if empty).
+ */
+ResponseSegment* SegmentPool::acquire()
+{
+    ResponseSegment* seg;
+
+    {
+        std::lock_guard<std::mutex> guard( _lock);
+        if ( !_free.empty()) {
+            seg = _free.back();
+            _free.pop_back();
+            return seg;
+        }
+    }
+
+    return new ResponseSegment();
+}
+
+
+/**
+ * @brief: return a segment to the pool. the payload string is cleared and
+ * kept with its capacity, for takePayload, unless it is longer than
+ * MAX_POOLED_PAYLOAD_LEN.
+ */
+void SegmentPool::release( ResponseSegment* seg)
+{
+    std::string& text = seg->payload.text;
+
+    if ( text.capacity() > MAX_POOLED_PAYLOAD_LEN) {
+        std::string().swap( text);
+    }
+    text.clear();
+    seg->payload.shared.reset();
+    seg->payload.offset = 0;
+    seg->headerLen = 0;
+
+    {
+        std::lock_guard<std::mutex> guard( _lock);
+        /* a short string is kept inline - it has no memory to reuse */
+        if ( text.capacity() > std::string().capacity() &&
+             _freePayloads.size() < MAX_POOLED_PAYLOADS) {
+            _freePayloads.push_back( std::move( text));
+            text.clear();
+        }
+        if ( _free.size() < MAX_POOLED_SEGMENTS) {
+            _free.push_back( seg);
+            return;
+        }
+    }
+
+    delete seg;
+}
+
+
+/**
+ * @brief: take an empty payload string that kept the capacity of a written
+ * response (or a new one if none) - a response built in it is not
+ * allocated again.
+ */
+std::string SegmentPool::takePayload()
+{
+    std::string payload;
+
+    {
+        std::lock_guard<std::mutex> guard( _lock);
+        if ( !_freePayloads.empty()) {
+            payload.swap( _freePayloads.back());
+            _freePayloads.pop_back();
+        }
+    }
+    return payload;
+}
+
+/*************** ResponseQueue **************************************/
+
+ResponseQueue::ResponseQueue(): _offset( 0)
+{}
+
+
+ResponseQueue::~ResponseQueue()
+{
+    _clear();
+}
+
+
+ResponseQueue::ResponseQueue( ResponseQueue&& other) noexcept:
+        _segments( std::move( other._segments)), _offset( other._offset)
+{
+    other._segments.clear();
+    other._offset = 0;
+}
+
+
+ResponseQueue& ResponseQueue::operator=( ResponseQueue&& other) noexcept
+{
+    if ( this != &other) {
+        _clear();
+        _segments.swap( other._segments);
+        _offset = other._offset;
+        other._offset = 0;
+    }
+    return *this;
+}
+
+
+/**
+ * @brief: queue a response as is - without a frame header.
+ */
+void ResponseQueue::push( Response payload)
+{
+    ResponseSegment* seg = SegmentPool::getInstance().acquire();
+
+    seg->payload = std::move( payload);
+    _segments.push_back( seg);
+}
+
+
+/**
+ * @brief: queue a session response in format of:
+ * <response length>\n<response>.
+ */
+void ResponseQueue::pushFramed( Response payload)
+{
+    ResponseSegment* seg = SegmentPool::getInstance().acquire();
+
+    seg->headerLen = snprintf( seg->header, MAX_FRAME_HEADER_LEN, "%zu\n",
+                               payload.size());
+    seg->payload = std::move( payload);
+    _segments.push_back( seg);
+}
+
+
+/**
+ * @brief: queue a binary protocol response frame.
+ */
+void ResponseQueue::pushBinary( int opcode, int status, uint32_t requestId,
+                                Response payload)
+{
+    ResponseSegment* seg = SegmentPool::getInstance().acquire();
+
+    BinaryProtocol::encodeHeader( seg->header, opcode, status, requestId,
+                                  (uint32_t) payload.size());
+    seg->headerLen = BINARY_HEADER_LEN;
+    seg->payload = std::move( payload);
+    _segments.push_back( seg);
+}
+
+
+/**
+ * @brief: move all the segments of other to the end of this queue.
+ */
+void ResponseQueue::splice( ResponseQueue& other)
+{
+    if ( _segments.empty()) {
+        _segments.swap( other._segments);
+        _offset = other._offset;
+    } else {
+        /* other was not written from yet - it is a queue of new responses */
+        _segments.insert( _segments.end(), other._segments.begin(),
+                          other._segments.end());
+        other._segments.clear();
+    }
+    other._offset = 0;
+}
+
+
+/**
+ * @brief: point up to maxIov iovecs at the bytes not written yet - the
+ * header and the payload of each segment, in order.
+ * @return: number of iovecs filled.
+ */
+int ResponseQueue::gather( struct iovec* iov, int maxIov) const
+{
+    std::deque<ResponseSegment*>::const_iterator it;
+    size_t skip = _offset;
+    int count = 0;
+    ResponseSegment* seg;
+
+    for ( it = _segments.begin(); it != _segments.end() && count + 2 <= maxIov;
+          ++it)
+    {
+        seg = *it;
+        if ( skip < seg->headerLen) {
+            iov[count].iov_base = seg->header + skip;
+            iov[count].iov_len = seg->headerLen - skip;
+            count++;
+            skip = 0;
+        } else {
+            skip -= seg->headerLen;
+        }
+
+        if ( skip < seg->payload.size()) {
+            iov[count].iov_base = (void*) (seg->payload.data() + skip);
+            iov[count].iov_len = seg->payload.size() - skip;
+            count++;
+        }
+        skip = 0; /* only the first segment is partly written */
+    }
+    return count;
+}
+
+
+/**
+ * @brief: mark the first n bytes not written yet as written, returning
+ * the finished segments to the pool.
+ */
+void ResponseQueue::consume( size_t n)
+{
+    ResponseSegment* seg;
+
+    _offset += n;
+    while ( !_segments.empty())
+    {
+        seg = _segments.front();
+        if ( _offset < seg->size()) {
+            break;
+        }
+        _offset -= seg->size();
+        _segments.pop_front();
+        SegmentPool::getInstance().release( seg);
+    }
+}
+
+
+/**
+ * @brief: one gathering send of the bytes not written yet to sock - like
+ * writev, but a peer that closed the connection is an EPIPE error and not
+ * a SIGPIPE.
+ * @return: the send result - bytes written or -1 on error.
+ */
+ssize_t ResponseQueue::writeTo( int sock)
+{
+    struct iovec iov[MAX_WRITE_IOVS];
+    struct msghdr msg;
+    ssize_t numWritten = 0;
+
+    memset( &msg, 0, sizeof(msg));
+    msg.msg_iov = iov;
+    msg.msg_iovlen = gather( iov, MAX_WRITE_IOVS);
+
+    if ( msg.msg_iovlen > 0) {
+        numWritten = sendmsg( sock, &msg, MSG_NOSIGNAL);
+        if ( numWritten < 0) {
+            return numWritten;
+        }
+    }
+    consume( numWritten); /* also drops the empty responses */
+    return numWritten;
+}
+
+/*************** Private Functions **************************************/
+
+/**
+ * @brief: release all the segments.
+ */
+void ResponseQueue::_clear()
+{
+    std::deque<ResponseSegment*>::iterator it;
+
+    for ( it = _segments.begin(); it != _segments.end(); ++it) {
+        SegmentPool::getInstance().release( *it);
+    }
+    _segments.clear();
+    _offset = 0;
+}
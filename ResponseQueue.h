@@ -0,0 +1,228 @@
+/*
+ * ResponseQueue.h
+ * Created on: Oct 17, 2026
+ * Author: nicole
+ */
+
+#ifndef RESPONSEQUEUE_H_
+#define RESPONSEQUEUE_H_
+
+#include <stdio.h>
+#include <unistd.h>
+#include <errno.h>
+#include <string>
+#include <string.h>
+#include <deque>
+#include <vector>
+#include <mutex>
+#include <memory> // shared_ptr
+#include <sys/types.h> // for size_t, ssize_t
+#include <sys/socket.h> // sendmsg
+#include <sys/uio.h>   // struct iovec
+
+#include "BinaryProtocol.h"
+
+/* room for the longest frame header - a binary header or <length>\n */
+#define MAX_FRAME_HEADER_LEN 24
+/* max number of iovecs gathered for one send (two per segment) */
+#define MAX_WRITE_IOVS 64
+/* max number of free segments kept by the pool */
+#define MAX_POOLED_SEGMENTS 4096
+/* max number of free payload strings kept by the pool */
+#define MAX_POOLED_PAYLOADS 1024
+/* longest capacity of a pooled payload string - a longer one is freed, so
+ * one huge response does not stay pinned in the pool */
+#define MAX_POOLED_PAYLOAD_LEN 8192
+
+
+/**
+ * the payload of a command response: a string of its own, or cached bytes
+ * that are shared with other responses and never change - from offset on,
+ * so a response can be the tail of a longer cached one.
+ */
+struct Response
+{
+    std::string text;
+    std::shared_ptr<const std::string> shared; /* if set, text is unused */
+    size_t offset; /* first byte of the response in shared */
+
+    Response(): offset( 0)
+    {}
+
+    Response( std::string text): text( std::move( text)), offset( 0)
+    {}
+
+    Response( std::shared_ptr<const std::string> shared, size_t offset = 0):
+            shared( std::move( shared)), offset( offset)
+    {}
+
+    /**
+     * @return: the response bytes.
+     */
+    const char* data() const {
+        return shared ? shared->data() + offset : text.data();
+    }
+
+    /**
+     * @return: number of the response bytes.
+     */
+    size_t size() const {
+        return shared ? shared->size() - offset : text.size();
+    }
+};
+
+
+/**
+ * one response waiting to be written: its frame header, kept inline, and
+ * the response payload, taken over from the command without a copy.
+ */
+struct ResponseSegment
+{
+    char header[MAX_FRAME_HEADER_LEN];
+    size_t headerLen;
+    Response payload;
+
+    ResponseSegment(): headerLen( 0)
+    {}
+
+    /**
+     * @return: number of bytes of the segment on the wire.
+     */
+    size_t size() const {
+        return headerLen + payload.size();
+    }
+};
+
+
+/**
+ * A singleton pool of reusable response segments, shared by all the
+ * connections and the workers that build their responses.
+ */
+class SegmentPool
+{
+public:
+
+    SegmentPool( SegmentPool const &other) = delete;
+    void operator=( SegmentPool const &other) = delete;
+
+    /**
+     * @brief: public getter - gets the singleton instance each call.
+     */
+    static SegmentPool& getInstance();
+
+    /**
+     * @brief: take a free segment from the pool (or a new one if empty).
+     */
+    ResponseSegment* acquire();
+
+    /**
+     * @brief: return a segment to the pool.
+     */
+    void release( ResponseSegment* seg);
+
+    /**
+     * @brief: take an empty payload string that kept the capacity of a
+     * written response (or a new one if none) - a response built in it is
+     * not allocated again.
+     */
+    std::string takePayload();
+
+private:
+
+    std::mutex _lock;
+    std::vector<ResponseSegment*> _free;
+    std::vector<std::string> _freePayloads;
+
+    SegmentPool();
+    virtual ~SegmentPool();
+};
+
+
+/**
+ * The responses of a connection that are not written yet, in order. Each
+ * response is a pooled segment of a small header and the payload as
+ * returned by the command (or shared from a cache), so framing never
+ * copies a payload. the queue is
+ * written with scatter-gather I/O, the header and payload of many segments
+ * in one call, and remembers how far a short write got.
+ */
+class ResponseQueue
+{
+public:
+
+    ResponseQueue();
+
+    virtual ~ResponseQueue();
+
+    ResponseQueue( ResponseQueue const &other) = delete;
+    void operator=( ResponseQueue const &other) = delete;
+
+    ResponseQueue( ResponseQueue&& other) noexcept;
+    ResponseQueue& operator=( ResponseQueue&& other) noexcept;
+
+    /**
+     * @brief: queue a response as is - without a frame header.
+     */
+    void push( Response payload);
+
+    /**
+     * @brief: queue a session response in format of:
+     * <response length>\n<response>.
+     */
+    void pushFramed( Response payload);
+
+    /**
+     * @brief: queue a binary protocol response frame.
+     */
+    void pushBinary( int opcode, int status, uint32_t requestId,
+                     Response payload);
+
+    /**
+     * @brief: move all the segments of other to the end of this queue.
+     */
+    void splice( ResponseQueue& other);
+
+    /**
+     * @return: true if there is nothing left to write.
+     */
+    bool empty() const {
+        return _segments.empty();
+    }
+
+    /**
+     * @return: number of responses not completely written yet.
+     */
+    size_t size() const {
+        return _segments.size();
+    }
+
+    /**
+     * @brief: point up to maxIov iovecs at the bytes not written yet.
+     * @return: number of iovecs filled.
+     */
+    int gather( struct iovec* iov, int maxIov) const;
+
+    /**
+     * @brief: mark the first n bytes not written yet as written, returning
+     * the finished segments to the pool.
+     */
+    void consume( size_t n);
+
+    /**
+     * @brief: one gathering send of the bytes not written yet to sock.
+     * @return: the send result - bytes written or -1 on error.
+     */
+    ssize_t writeTo( int sock);
+
+private:
+
+    std::deque<ResponseSegment*> _segments;
+    size_t _offset; /* bytes of the first segment already written */
+
+    /**
+     * @brief: release all the segments.
+     */
+    void _clear();
+};
+
+#endif /* RESPONSEQUEUE_H_ */
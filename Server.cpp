@@ -6,12 +6,16 @@
 
 #include "Server.h"
 
+/* log lines of the batch the calling thread applies - the single writer
+ * logs a batch at once */
+static thread_local std::vector<std::string>* logBatch = nullptr;
+
 /*************** Private Functions **************************************/
 
 /**
  * @brief: private Constructor - default ctor.
  */
-Server::Server(): _logger( nullptr), _nextEventId( 1)
+Server::Server(): _logger( nullptr), _events( _names), _sequencer( nullptr)
 {}
 
 
@@ -21,7 +25,7 @@ Server::Server(): _logger( nullptr), _nextEventId( 1)
  */
 bool Server::_isEventExist( int eventId)
 {
-    return (_eventsMap.find( eventId) != _eventsMap.end());
+    return _events.exists( eventId);
 }
 
 
@@ -29,36 +33,117 @@ bool Server::_isEventExist( int eventId)
  * @brief: checks if exists a client with given client name.
  * @return: true if there is client with this client name.
  */
-bool Server::_isClientExist( const std::string client)
+bool Server::_isClientExist( const std::string& client)
 {
-    std::string clientUp( client);
-    /* transform first command word to upper case */
-    std::transform(clientUp.begin(),clientUp.end(),clientUp.begin(),::toupper);
-    return ( _clientsSet.find( clientUp) != _clientsSet.end());
+    return _clients.contains( _names.find( client));
 }
 
 
 /**
  * @brief: in case a client chose to unregister- the server removes
- * it's name from the guests list of each event that he might have sent
- * a RSVP request. events with empty guests list will remain.
+ * it's name from the guests list of each event that he sent a RSVP
+ * request to (the client reverse index). events with empty guests list
+ * will remain.
+ */
+void Server::_removeClientFromEvents( NameId client,
+                                     const std::vector<int>& events)
+{
+    _events.removeGuest( events, client);
+}
+
+
+/**
+ * @brief: run the complete requests of conn that are in its reader. the
+ * first line names the client - SESSION <client name> and BINARY <client
+ * name> open a session, any other line is the client name of a plain
+ * connection that carries one command line.
+ * @param atEOF: the client closed its side - the rest is the last line.
+ * @return: false on a protocol error.
  */
-void Server::_removeClientFromEvents( const std::string client)
+bool Server::_runRequests( ClientConnection& conn, bool atEOF,
+                           ResponseQueue& responses)
 {
-    std::map<int, Event*>::iterator it;
+    Server& server = Server::getInstance();
+    BinaryHeader header;
+    std::string line, payload;
+    int res;
+
+    if ( !conn.named) {
+        if ( !conn.reader.nextLine( line, atEOF)) {
+            return true; /* wait for the rest of the line */
+        }
+        conn.named = true;
+        if ( CommandParser::isSessionRequest( line, conn.client)) {
+            conn.session = true;
+        } else if ( CommandParser::isBinarySessionRequest( line,
+                                                           conn.client)) {
+            conn.session = true;
+            conn.binary = true;
+        } else {
+            conn.client = line;
+        }
+    }
+
+    if ( conn.binary) {
+        while ( (res = BinaryProtocol::takeFrame( conn.reader, header,
+                                                  payload)) == 1) {
+            server.executeBinary( conn.client, header, payload, responses);
+        }
+        if ( res < 0) {
+            Server::logServerError( "read", "binary frame is too long");
+            return false;
+        }
+        return true;
+    }
+
+    /* the pipelined commands already read run in request order */
+    while ( (conn.session || responses.empty()) &&
+            conn.reader.nextLine( line, atEOF)) {
+        if ( conn.session) {
+            responses.pushFramed( server.parseCommand( conn.client, line));
+        } else {
+            responses.push( server.parseCommand( conn.client, line));
+        }
+    }
 
-    /* iterate over all events and remove client guest that was unregistered*/
-    for (it = _eventsMap.begin(); it != _eventsMap.end(); ++it)
+    if ( conn.reader.overflow()) {
+        Server::logServerError( "read", "request line is too long");
+        return false;
+    }
+    return true;
+}
+
+
+/**
+ * @brief: write all the queued responses to the socket, handling short
+ * writes - the headers and payloads are gathered straight from the queue.
+ * @return: false on write error.
+ */
+bool Server::_writeAll( int sock, ResponseQueue& responses)
+{
+    while ( !responses.empty())
     {
-        (it->second)->removeGuest( client);
+        if ( responses.writeTo( sock) < 0) {
+            if ( errno == EINTR) {
+                continue;
+            }
+            Server::logServerError( "write", std::to_string( errno));
+            return false;
+        }
     }
+    return true;
 }
 
 /*************** Public Functions **************************************/
 
-void Server::logServer( const std::string response)
+void Server::logServer( const std::string& response)
 {
     Server& server = Server::getInstance();
+
+    if ( logBatch != nullptr) {
+        logBatch->push_back( response);
+        return;
+    }
     server._logger->logCommand( response);
 }
 
@@ -93,57 +178,77 @@ Server& Server::getInstance()
 }
 
 
-void Server::initServer()
+bool Server::initServer( bool sequenced, int newestMax, size_t memoryBudget)
 {
 	_logger = new Logger( LOGNAME);
+	_events.setNewestMax( newestMax);
+	if ( sequenced) {
+		_sequencer = new CommandSequencer( std::bind( &Server::_applyBatch,
+		                                   this, std::placeholders::_1));
+	}
+	return _events.setMemoryBudget( memoryBudget);
 }
 
 
 /**
- * @brief: read client request from given socket into the buffer and
- * write server response to this socket.
+ * @return: the statistics of the single writer, empty if not sequenced.
  */
-void Server::handleClient( int sock)
+std::string Server::sequencerStats()
 {
-    Server& server = Server::getInstance();
-   int numRead;
-   int bytesToRead = 99999;
-   std::string request = "", response = "";
-   char* sendbuf;
-   std::string client;
-   char readbuf[bytesToRead];
-
-   memset( readbuf, 0, bytesToRead);
-
-   numRead = read( sock, readbuf, bytesToRead);
-   if (numRead < 0) {
-       Server::logServerError("read", "read buffer received empty");
-   }
-
-   /* the response of the server: */
-   request = std::string( readbuf);
-
-   std::size_t found = request.find("\n");
-   if (found != std::string::npos) {
-       client = request.substr( 0, found);
-       request = request.substr( found+1);
-       found = request.find("\n");
-       if (found != std::string::npos) {
-           request = request.substr( 0, found);
-       }
-       response = server.parseCommand( client, request);
-   }
-
-   /* write a response to client's socket */
-   sendbuf = (char *)malloc(sizeof(char)*(response.length()+1));
-   memset( sendbuf, 0, response.length()+1);
-   const char* resp = response.c_str();
-   strcpy( sendbuf, resp);
-
-   write( sock, sendbuf, strlen( sendbuf));
-   free( sendbuf);
-
-   close( sock);
+    if ( _sequencer == nullptr) {
+        return "";
+    }
+    return _sequencer->stats();
+}
+
+
+/**
+ * @return: the memory statistics of the events, empty without a budget.
+ */
+std::string Server::eventStats()
+{
+    return _events.stats();
+}
+
+
+/**
+ * @brief: read the bytes the client sent since the last call and write back
+ * the responses of its complete requests. a plain connection carries one
+ * request: <client name>\n<command line>\n and is closed after the
+ * response. a session connection starts with SESSION <client name>\n and
+ * then carries many command lines, each answered with a framed response,
+ * until the client closes it. pipelined commands are answered in request
+ * order. a session opened with BINARY <client name> uses the binary
+ * protocol. the socket is readable, so the one read call does not block -
+ * an idle session holds no worker between its requests.
+ * @return: true if the connection waits for more requests, false if it was
+ * closed.
+ */
+bool Server::handleClient( ClientConnection& conn)
+{
+    ResponseQueue responses;
+    ssize_t numRead;
+    bool atEOF, done;
+
+    do {
+        numRead = conn.reader.fill( conn.sock);
+    } while ( numRead < 0 && errno == EINTR);
+    if ( numRead < 0) {
+        Server::logServerError( "read", std::to_string( errno));
+    }
+    atEOF = numRead <= 0;
+
+    done = !_runRequests( conn, atEOF, responses);
+    /* a plain connection is done with its one response */
+    if ( !conn.session && !responses.empty()) {
+        done = true;
+    }
+
+    if ( !_writeAll( conn.sock, responses) || done || atEOF) {
+        close( conn.sock);
+        return false;
+    }
+    return true;
 }
 
 
@@ -151,78 +256,189 @@ void Server::handleClient( int sock)
  * @brief: the server receives the user request that begins with the
  * command and it's arguments, parses request into tokens, identifies
  * the command type and passes next to the relevant command function
- * that will return the response string.
+ * that will return the response string. the tokens and the arguments are
+ * slices of request - parsing allocates nothing.
  * @return: response string.
  */
-std::string Server::parseCommand(const std::string client, std::string request)
+Response Server::parseCommand( const std::string& client,
+                               const std::string& request)
 {
-    std::string token;
-    std::string response;
-    std::vector<std::string> tokens;
-    CommandParser::tokenize( request, " ", tokens);
-    std::string command = tokens[0];
-    size_t hasNewLine = 0;
-    /* transform first command word to upper case */
-    std::transform( command.begin(), command.end(),command.begin(),::toupper);
-    int eventId;
-    int commType = CommandParser::getCommandType( command);
+    StrRef tokens[MAX_COMMAND_TOKENS];
+    CommandArgs args;
+    int status;
+    size_t numTokens = CommandParser::tokenize( request, ' ', tokens,
+                                                MAX_COMMAND_TOKENS);
+    if ( numTokens == 0) {
+        return ILLEGAL_COMMAND;
+    }
+    int commType = CommandParser::getCommandType( tokens[0]);
+    const std::string& command = CommandParser::commandName( commType);
 
     switch( commType)
     {
-        case REGISTER:
-           response = registerClient( client);
-           break;
-
         case CREATE:
-            if ( tokens.size() > 4) {
-                CommandParser::joinTokens( tokens, " ", 3);
+            /* the description is the rest of the line */
+            if ( numTokens < 4) {
+                return CommandParser::logCommandError( client, MISS_ARGS,
+                                                       command);
             }
-           response = createEvent( client, tokens[1], tokens[2], tokens[3]);
-           break;
-
-        case UNREGISTER:
-            response = unregisterClient( client);
+            args.title = tokens[1];
+            args.date = tokens[2];
+            args.description = CommandParser::restOfLine( request, tokens[3],
+                                                          ' ');
             break;
 
         case SEND_RSVP:
-            hasNewLine = tokens[1].find("\n");
-            if (hasNewLine != std::string::npos){
-                tokens[1] = tokens[1].substr( 0, hasNewLine);
+        case GET_RSVPS_LIST:
+            if ( numTokens < 2) {
+                return CommandParser::logCommandError( client, MISS_ARGS,
+                                                       command);
             }
-            if ( CommandParser::isStrNumber( tokens[1])) {
-                eventId = stoi( tokens[1]);
-                response = sendRSVP( client, eventId);
-            } else {
-                response = CommandParser::logCommandError( client,
-                           INVALID_ARG_COMMAND, command, tokens[1]);
+            if ( !CommandParser::toNumber( tokens[1], args.eventId)) {
+                return CommandParser::logCommandError( client,
+                       INVALID_ARG_COMMAND, command, tokens[1].str());
+            }
+            /* GET_RSVPS_LIST <id> <cursor> [limit] - a page of the list */
+            if ( commType != GET_RSVPS_LIST || numTokens < 3) {
+                break;
+            }
+            args.cursor = tokens[2];
+            args.limit = DEFAULT_LIST_LIMIT;
+            if ( numTokens > 3 &&
+                 (!CommandParser::toNumber( tokens[3], args.limit) ||
+                  args.limit < 1 || args.limit > MAX_LIST_LIMIT)) {
+                return CommandParser::logCommandError( client,
+                       INVALID_ARG_COMMAND, command, tokens[3].str());
             }
             break;
 
-        case GET_RSVPS_LIST:
-            hasNewLine = tokens[1].find("\n");
-            if (hasNewLine != std::string::npos){
-                tokens[1] = tokens[1].substr( 0, hasNewLine);
+        case GET_TOP:
+            if ( numTokens < 2) {
+                return CommandParser::logCommandError( client, MISS_ARGS,
+                                                       command);
             }
-            if ( CommandParser::isStrNumber( tokens[1])) {
-                eventId = stoi( tokens[1]);
-                /* get list of guests as string */
-                response = getRSVP_List( client, eventId);
-            } else {
-                response = CommandParser::logCommandError( client,
-                           INVALID_ARG_COMMAND, command, tokens[1]);
+            if ( !CommandParser::toNumber( tokens[1], args.count)) {
+                return CommandParser::logCommandError( client,
+                       INVALID_ARG_COMMAND, command, tokens[1].str());
             }
             break;
+    }
+
+    return execute( client, commType, args, status);
+}
+
+
+/**
+ * @brief: run the command of the given type with its already parsed
+ * arguments - shared by the text and the binary protocols.
+ * @param status: set to the ResponseStatus of the command result.
+ * @return: response string.
+ */
+Response Server::execute( const std::string& client, int commType,
+                          const CommandArgs& args, int& status)
+{
+    if ( _sequencer != nullptr && (commType == REGISTER ||
+         commType == UNREGISTER || commType == CREATE ||
+         commType == SEND_RSVP)) {
+        /* mutations go to the single writer - reads stay on this thread */
+        Mutation mutation( client, commType, args);
+        _sequencer->run( mutation);
+        status = mutation.status;
+        return std::move( mutation.response);
+    }
+
+    return _apply( client, commType, args, status);
+}
+
+
+/**
+ * @brief: single writer side - apply a batch of mutating commands in order
+ * and write their log lines at once.
+ */
+void Server::_applyBatch( std::vector<Mutation*>& batch)
+{
+    std::vector<Mutation*>::iterator it;
+    std::vector<std::string> lines;
+    Mutation* mutation;
+
+    logBatch = &lines;
+    for ( it = batch.begin(); it != batch.end(); ++it) {
+        mutation = *it;
+        /* mutations are never cached - their response is a string */
+        mutation->response = std::move( _apply( mutation->client,
+                                                mutation->commType,
+                                                mutation->args,
+                                                mutation->status).text);
+    }
+    logBatch = nullptr;
+
+    _logger->logCommands( lines);
+}
+
+
+/**
+ * @brief: run the command of the given type on the calling thread.
+ * @param status: set to the ResponseStatus of the command result.
+ * @return: response string.
+ */
+Response Server::_apply( const std::string& client, int commType,
+                         const CommandArgs& args, int& status)
+{
+    status = STATUS_OK;
+
+    switch( commType)
+    {
+        case REGISTER:
+            return registerClient( client, status);
+
+        case CREATE:
+            return createEvent( client, args.title, args.date,
+                                args.description, status);
+
+        case UNREGISTER:
+            return unregisterClient( client, status);
+
+        case SEND_RSVP:
+            return sendRSVP( client, args.eventId, status);
+
+        case GET_RSVPS_LIST:
+            if ( !args.cursor.empty()) {
+                return getRSVP_Page( client, args.eventId, args.cursor,
+                                     args.limit, status);
+            }
+            /* get list of guests as string */
+            return getRSVP_List( client, args.eventId, status);
 
         case GET_TOP_5:
-            response = getTop5Events( client);
-            break;
+            return getTop5Events( client, status);
 
-        case ILLEGAL:
-            response = ILLEGAL_COMMAND;
-            break;
+        case GET_TOP:
+            return getTopEvents( client, args.count, status);
     }
 
-    return response;
+    status = STATUS_ERROR;
+    return ILLEGAL_COMMAND;
+}
+
+
+/**
+ * @brief: run one binary request frame and queue its response frame - the
+ * response is moved into the frame payload, not copied.
+ */
+void Server::executeBinary( const std::string& client,
+                            const BinaryHeader& header,
+                            const std::string& payload, ResponseQueue& out)
+{
+    CommandArgs args;
+    int status = STATUS_ERROR;
+    Response response( ILLEGAL_COMMAND);
+
+    if ( BinaryProtocol::decodeArgs( header.opcode, payload, args)) {
+        response = execute( client, header.opcode, args, status);
+    }
+
+    out.pushBinary( header.opcode, status, header.requestId,
+                    std::move( response));
 }
 
 
@@ -230,22 +446,35 @@ std::string Server::parseCommand(const std::string client, std::string request)
  * @brief: register new client.
  * @return: result of registration.
  */
-std::string Server::registerClient( const std::string client)
+std::string Server::registerClient( const std::string& client, int& status)
 {
     std::string response;
     std::string serverLog;
-    std::string clientUp( client);
-    /* transform first command word to upper case */
-    std::transform(clientUp.begin(),clientUp.end(),clientUp.begin(),::toupper);
+    NameId clientId;
+
+    if ( client == LIST_CURSOR_START) {
+        /* a guest by this name would page from the first page forever */
+        serverLog = "ERROR: " + client + "\t" + NAME_RESERVED;
+        response = "ERROR: the client " + client + NAME_RESERVED;
+        status = STATUS_ERROR;
+        Server::logServer( serverLog);
+        return response;
+    }
 
-    if ( !_isClientExist( clientUp))
+    clientId = _names.intern( client);
+    if ( clientId == NO_NAME) {
+        serverLog = "ERROR: " + client + "\t" + SERVER_FULL;
+        response = "ERROR: the client " + client + SERVER_FULL;
+        status = STATUS_FULL;
+    } else if ( _clients.add( clientId))
     {
-        _clientsSet.insert( clientUp);
         serverLog = client + "\t" + REGISTER_SUCCESS;
         response = "SUCCESS";
+        status = STATUS_OK;
     } else {
         serverLog = "ERROR: " + client + "\t" + ALREADY_REGISTERED;
         response = "ERROR: the client " + client + CLIENT_REGISTERED;
+        status = STATUS_ALREADY;
     }
 
     Server::logServer( serverLog);
@@ -257,25 +486,25 @@ std::string Server::registerClient( const std::string client)
  * @brief: unregister existing client.
  * @return: result of registration.
  */
-std::string Server::unregisterClient( const std::string client)
+std::string Server::unregisterClient( const std::string& client, int& status)
 {
     std::string serverLog;
     std::string response;
-    std::string clientUp( client);
-    /* transform first command word to upper case */
-    std::transform(clientUp.begin(),clientUp.end(),clientUp.begin(),::toupper);
+    NameId clientId = _names.find( client);
+    std::vector<int> events;
 
-    if ( _isClientExist( clientUp))
+    if ( _clients.remove( clientId, events))
     {
-        _clientsSet.erase(clientUp);
-        _removeClientFromEvents( clientUp);
+        _removeClientFromEvents( clientId, events);
 
         serverLog = client + "\t" + " was unregistered successfully.";
         Server::logServer( serverLog);
         response = "SUCCESS";
+        status = STATUS_OK;
         return response;
     } else {
         response = NOT_REGISTERED;
+        status = STATUS_NOT_REGISTERED;
     }
 
     return response;
@@ -286,42 +515,40 @@ std::string Server::unregisterClient( const std::string client)
  * @brief: create new event
  * @return: new event id.
  */
-std::string Server::createEvent( const std::string client,
-                                 const std::string title,
-                                 const std::string date,
-                                 const std::string description)
+std::string Server::createEvent( const std::string& client, StrRef title,
+                                 StrRef date, StrRef description,
+                                 int& status)
 {
-    Event* event;
-    int eventId = _nextEventId;
+    int eventId;
     std::string serverLog;
     std::string response;
-    std::string eventIdStr = std::to_string(eventId);
+    std::string eventIdStr;
 
     if ( !_isClientExist( client)) {
         response = NOT_REGISTERED;
+        status = STATUS_NOT_REGISTERED;
         return response;
     }
 
-    if ( _isEventExist( _nextEventId)) {
-        _nextEventId++;
-        eventId = _nextEventId;
-    }
-
     try {
-        event = new Event( client, eventId, title, date, description);
-        _eventList.push_back( event);
-        _eventsMap[eventId] = event;
-        response ="Event id " + eventIdStr +" was created successfully.";
-
+        eventId = _events.create( client, title, date, description);
     } catch ( std::bad_alloc& e) {
-        _nextEventId--;
         response = ERROR_EVENT_ALLOC;
+        status = STATUS_ERROR;
         return response;
     }
 
+    eventIdStr = std::to_string( eventId);
+    /* built in a pooled payload string - not allocated */
+    response = SegmentPool::getInstance().takePayload();
+    response += "Event id ";
+    response += eventIdStr;
+    response += " was created successfully.";
+    status = STATUS_OK;
+
     serverLog = client + "\t" + " event id " + eventIdStr;
-    serverLog += " was assigned to the event with title " + title + ".";
-    _nextEventId++;
+    serverLog += " was assigned to the event with title ";
+    serverLog.append( title.data, title.size) += ".";
     Server::logServer( serverLog);
     return response;
 }
@@ -331,25 +558,35 @@ std::string Server::createEvent( const std::string client,
  * @brief: send RSVP to event
  * @return: result of trying to register to event.
  */
-std::string Server::sendRSVP( const std::string client, int eventId)
+std::string Server::sendRSVP( const std::string& client, int eventId,
+                              int& status)
 {
     std::string response;
     std::string serverLog;
     std::string eventID = std::to_string( eventId);
     std::string errorDesc;
+    NameId clientId = _names.find( client);
 
-    if ( !_isClientExist( client)) {
+    if ( !_clients.contains( clientId)) {
          response = NOT_REGISTERED;
+         status = STATUS_NOT_REGISTERED;
          return response;
      }
 
-    if ( _isEventExist( eventId)) {
-        response = _eventsMap[eventId]->registerClient( client);
+    if ( _events.addGuest( eventId, clientId, response, status)) {
+        if ( status == STATUS_OK && !_clients.addEvent( clientId, eventId)) {
+            /* unregistered meanwhile - its events were already swept */
+            _events.removeGuest( std::vector<int>( 1, eventId), clientId);
+            response = NOT_REGISTERED;
+            status = STATUS_NOT_REGISTERED;
+            return response;
+        }
         serverLog = client + "\t" + " is RSVP to event with id " + eventID+".";
     } else {
         /* if client tries to register to event that does not exist - error */
         response = "ERROR: " + EVENT_NOT_EXIST;
         serverLog = "ERROR: " + EVENT_NOT_EXIST;
+        status = STATUS_ERROR;
     }
 
     Server::logServer( serverLog);
@@ -365,25 +602,20 @@ void Server::exitServer()
 {
     Server& server = Server::getInstance();
     std::string serverLog;
+
+    /* the commands left are applied before the log is closed */
+    delete server._sequencer;
+    server._sequencer = nullptr;
+
     serverLog = "EXIT command is typed: server is shutdown";
     Server::logServer( serverLog);
     /* close server log and delete instance */
     sleep(2); // time out 2 seconds
     delete server._logger;
 
-    std::vector<Event*>::iterator it;
-
-    server._clientsSet.clear();
-    server._eventsMap.clear();
-
-    it = server._eventList.begin();
-    while ( it != server._eventList.end()) {
-        if (*it != nullptr){
-            delete *it;
-        }
-        server._eventList.erase(it);
-    }
-    server._eventList.clear();
+    server._clients.clear();
+    server._events.clear();
+    server._topCache.reset();
 }
 
 
@@ -391,66 +623,138 @@ void Server::exitServer()
  * @brief: tries to get the guests list associated with the given eventId.
  * @return: guests list response or and error response if invalid id.
  */
-std::string Server::getRSVP_List( const std::string client, int eventId)
+Response Server::getRSVP_List( const std::string& client, int eventId,
+                               int& status)
 {
-    std::list<std::string> list;
+    std::shared_ptr<const std::string> guests;
     std::string serverLog, listStr = "";
 
     if ( !_isClientExist( client)) {
         listStr = NOT_REGISTERED;
+        status = STATUS_NOT_REGISTERED;
          return listStr;
      }
 
 
-    /* add each guest in the event guests list to listStr*/
-    if ( _isEventExist( eventId)) {
-        list = _eventsMap[eventId]->getGuestList();
-        if ( list.size() > 0) {
-            listStr = CommandParser::convertListToString( list, ",");
-        }
+    /* the guests list of the event - cached until its guests change */
+    if ( _events.getGuestList( eventId, guests)) {
         serverLog = client + "\t" + " requests the RSVP'S list for event with id ";
         serverLog += std::to_string( eventId) + ".";
         Server::logServer( serverLog);
+        status = STATUS_OK;
+        return guests;
 
     } else {
         listStr = "ERROR: " + EVENT_NOT_EXIST;
         Server::logServerError("GET_RSVPS_LIST", EVENT_NOT_EXIST);
+        status = STATUS_ERROR;
     }
 
     return listStr;
 }
 
 
+/**
+ * @brief: tries to get a page of the guests list of the given eventId -
+ * the guests after the name cursor (LIST_CURSOR_START for the first page),
+ * at most limit of them. a client walks a long list page after page, each
+ * one built alone and of bounded size.
+ * @return: <next cursor>\t<guests> - the next cursor is empty after the
+ * last page - or an error response if invalid id.
+ */
+Response Server::getRSVP_Page( const std::string& client, int eventId,
+                               StrRef cursor, int limit,
+                               int& status)
+{
+    std::string serverLog, next, listStr;
+    StrRef after = cursor == LIST_CURSOR_START ? StrRef() : cursor;
+
+    if ( !_isClientExist( client)) {
+        status = STATUS_NOT_REGISTERED;
+        return NOT_REGISTERED;
+    }
+
+    listStr = SegmentPool::getInstance().takePayload();
+    if ( _events.getGuestPage( eventId, after, limit, listStr, next)) {
+        serverLog = client + "\t" + " requests the RSVP'S list for event with id ";
+        serverLog += std::to_string( eventId) + " after ";
+        serverLog.append( cursor.data, cursor.size) += ".";
+        Server::logServer( serverLog);
+        status = STATUS_OK;
+        /* the page is built in a pooled payload string - the cursor goes
+         * in front of it in place */
+        listStr.insert( 0, 1, '\t');
+        listStr.insert( 0, next);
+        return std::move( listStr);
+    }
+
+    Server::logServerError("GET_RSVPS_LIST", EVENT_NOT_EXIST);
+    status = STATUS_ERROR;
+    return "ERROR: " + EVENT_NOT_EXIST;
+}
+
+
 /**
  * @brief: gets the top five most recent new added events. in case there
  * are less then five it returns those events.
  * @return: events list as string.
  */
-std::string Server::getTop5Events( const std::string client)
+Response Server::getTop5Events( const std::string& client, int& status)
 {
-    std::vector<Event*>::iterator it;
-    size_t firstIdx = 0;
-    size_t listSize = _eventList.size();
+    return getTopEvents( client, TOP_5, status);
+}
+
+
+/**
+ * @brief: gets the count most recent new added events, oldest first. in
+ * case there are less it returns those events. count is at most the
+ * configured max (-t). the response to the largest count asked since the
+ * last create is cached, and a smaller count is served from its tail.
+ * @return: events list as string.
+ */
+Response Server::getTopEvents( const std::string& client, int count,
+                               int& status)
+{
+    std::shared_ptr<const std::string> cached;
+    std::vector<size_t> records;
+    uint64_t version;
+    size_t offset = 0;
     std::string serverLog, listStr = "";
-    serverLog = client + "\t" + " requests the top 5 newest events.";
+    std::string countStr = std::to_string( count);
+    serverLog = client + "\t" + " requests the top " + countStr +
+                " newest events.";
     /* ech event should be printed in the following format:
      * <eventId>\t<eventTitle>\t<eventDate>\t<eventDescription>.\n*/
 
     if ( !_isClientExist( client)) {
         listStr = NOT_REGISTERED;
+        status = STATUS_NOT_REGISTERED;
          return listStr;
      }
 
-    if (listSize > 5) {
-        firstIdx = listSize - 5;
+    if ( count < 1 || count > _events.newestMax()) {
+        listStr = CommandParser::logCommandError( client, INVALID_ARG_COMMAND,
+                                                  "GET_TOP", countStr);
+        status = STATUS_ERROR;
+        return listStr;
     }
 
-    for ( it = _eventList.begin() + firstIdx; it != _eventList.end(); ++it)
-    {
-        listStr += (*it)->toString();
+    /* a create bumps the version - the newest count events are the tail of
+     * the response to any larger count of the same version. a miss builds
+     * count events only, so the cached tail grows only when a larger count
+     * is asked of the same version */
+    version = _events.newestVersion();
+    cached = _topCache.getTail( version, count, offset);
+    if ( cached == nullptr) {
+        /* read from the ring of the newest events - without a lock */
+        _events.newest( count, listStr, records);
+        listStr += ".";
+        offset = ResponseCache::tailOffset( records, count);
+        cached = _topCache.putTail( version, std::move( listStr),
+                                    std::move( records), count);
     }
-    listStr += ".";
+    status = STATUS_OK;
 
     Server::logServer( serverLog);
-    return listStr;
+    return Response( cached, offset);
 }
@@ -24,14 +24,43 @@
 #include <sys/socket.h>
 #include <netinet/in.h>
 #include <pthread.h>
-#include <sys/socket.h>
+#include <errno.h>
 
 #include "Logger.h"
 #include "Event.h"
 #include "CommandParser.h"
+#include "RequestReader.h"
+#include "BinaryProtocol.h"
+#include "ResponseQueue.h"
+#include "EventStore.h"
+#include "NameTable.h"
+#include "ClientRegistry.h"
+#include "CommandSequencer.h"
+#include "ResponseCache.h"
 
 /* server log name - includes all the commands it received */
 #define LOGNAME "emServer.log"
+/* count of events GET_TOP_5 returns */
+#define TOP_5 5
+
+
+/**
+ * state of a client connection of the select engine between its jobs - the
+ * connection waits for its next bytes in the select set, not on a worker.
+ */
+struct ClientConnection
+{
+    int sock;
+    RequestReader reader; /* pooled buffer of the bytes read so far */
+    std::string client;   /* the client name */
+    bool named;           /* the client name line was received */
+    bool session;         /* persistent connection of many commands */
+    bool binary;          /* session of the binary protocol */
+
+    ClientConnection( int sockFD): sock( sockFD), named( false),
+            session( false), binary( false)
+    {}
+};
 
 
 /**
@@ -42,7 +71,7 @@ class Server
 {
 public:
 
-    static void logServer( const std::string response);
+    static void logServer( const std::string& response);
 
     /**
      * @brief: Every error message in the server log (except system call error)
@@ -83,15 +112,36 @@ public:
 
 	/**
 	 * @brief: Initialize the cache manager.
+	 * @param sequenced: apply all the mutating commands on one writer
+	 * thread, in batches, instead of on the calling threads.
+	 * @param newestMax: the max count of GET_TOP.
+	 * @param memoryBudget: bytes of events kept in memory before cold
+	 * events are spilled to disk, 0 - no budget.
+	 * @return: false if the spill file can not be created (errno is set).
 	 */
-	void initServer();
+	bool initServer( bool sequenced = false,
+	                 int newestMax = DEFAULT_NEWEST_MAX,
+	                 size_t memoryBudget = 0);
 
+	/**
+	 * @return: the statistics of the single writer, empty if not sequenced.
+	 */
+	std::string sequencerStats();
 
 	/**
-	 * @brief: read client request from given socket into the buffer and
-	 * write server response to this socket.
+	 * @return: the memory statistics of the events, empty without a budget.
 	 */
-	static void handleClient( int sock);
+	std::string eventStats();
+
+
+	/**
+	 * @brief: read the bytes the client sent since the last call (one read
+	 * call - the socket is readable), run its complete requests and write
+	 * back their responses.
+	 * @return: true if the connection waits for more requests, false if it
+	 * was closed.
+	 */
+	static bool handleClient( ClientConnection& conn);
 
 
 	/**
@@ -99,37 +149,54 @@ public:
 	 * command and it's arguments, parses request into tokens, identifies
 	 * the command type and passes next to the relevant command function
 	 * that will return the response string.
-	 * @return: response string.
+	 * @return: response - its own string or cached bytes.
+	 */
+	Response parseCommand( const std::string& client,
+	                       const std::string& request);
+
+	/**
+	 * @brief: run the command of the given type with its already parsed
+	 * arguments - shared by the text and the binary protocols.
+	 * @param status: set to the ResponseStatus of the command result.
+	 * @return: response - its own string or cached bytes.
+	 */
+	Response execute( const std::string& client, int commType,
+	                  const CommandArgs& args, int& status);
+
+	/**
+	 * @brief: run one binary request frame and queue its response frame.
 	 */
-	std::string parseCommand( const std::string client, std::string request);
+	void executeBinary( const std::string& client, const BinaryHeader& header,
+	                    const std::string& payload, ResponseQueue& out);
 
-	/* client requests from server */
+	/* client requests from server - each sets status to the ResponseStatus
+	 * of its result */
 
     /**
      * @brief: register new client.
      * @return: result of registration.
      */
-	std::string registerClient( const std::string client);
+	std::string registerClient( const std::string& client, int& status);
 
 
     /**
      * @brief: unregister existing client.
      * @return: result of registration.
      */
-	std::string unregisterClient( const std::string client);
+	std::string unregisterClient( const std::string& client, int& status);
 
 	/**
 	 * @brief: create new event
 	 * @return: new event id.
 	 */
-    std::string createEvent( const std::string client, const std::string title,
-	                         const std::string date,const std::string description);
+    std::string createEvent( const std::string& client, StrRef title,
+	                         StrRef date, StrRef description, int& status);
 
     /**
      * @brief: send RSVP to event
      * @return: result of trying to register to event.
      */
-    std::string sendRSVP( const std::string client, int eventId);
+    std::string sendRSVP( const std::string& client, int eventId, int& status);
 
 
 	/**
@@ -143,28 +210,63 @@ public:
      * @brief: tries to get the guests list associated with the given eventId.
      * @return: guests list response or and error response if invalid id.
      */
-	std::string getRSVP_List( const std::string client, int eventId);
+	Response getRSVP_List( const std::string& client, int eventId,
+	                       int& status);
+
+    /**
+     * @brief: tries to get a page of the guests list of the given eventId -
+     * the guests after the name cursor (LIST_CURSOR_START for the first
+     * page), at most limit of them.
+     * @return: <next cursor>\t<guests> - the next cursor is empty after the
+     * last page - or an error response if invalid id.
+     */
+	Response getRSVP_Page( const std::string& client, int eventId,
+	                       StrRef cursor, int limit, int& status);
 
     /**
      * @brief: gets the top five most recent new added events. in case there
      * are less then five it returns those events.
      * @return: events list as string.
      */
-	std::string getTop5Events( const std::string client);
+	Response getTop5Events( const std::string& client, int& status);
+
+    /**
+     * @brief: gets the count most recent new added events. in case there
+     * are less it returns those events.
+     * @return: events list as string.
+     */
+	Response getTopEvents( const std::string& client, int count,
+	                       int& status);
 
 private:
 
 	Logger *_logger;
-	int _nextEventId;
-	std::vector<Event*> _eventList;
-	std::set<std::string /*client name*/> _clientsSet;
-	std::map<int /*eventId*/, Event*> _eventsMap;
+	/* commands run on many threads at once - both are thread safe */
+	NameTable _names; /* interned client names */
+	EventStore _events;
+	ClientRegistry _clients;
+	CommandSequencer* _sequencer; /* the single writer, if sequenced */
+	ResponseCache _topCache; /* GET_TOP response to the largest count */
 
 	/**
 	 * @brief: private Constructor - default ctor.
 	 */
 	Server();
 
+	/**
+	 * @brief: run the command of the given type on the calling thread.
+	 * @param status: set to the ResponseStatus of the command result.
+	 * @return: response - its own string or cached bytes.
+	 */
+	Response _apply( const std::string& client, int commType,
+	                 const CommandArgs& args, int& status);
+
+	/**
+	 * @brief: single writer side - apply a batch of mutating commands in
+	 * order and write their log lines at once.
+	 */
+	void _applyBatch( std::vector<Mutation*>& batch);
+
     /**
      * @brief: checks if exists an event with given eventId.
      * @return: true if there is event with this id.
@@ -175,14 +277,30 @@ private:
      * @brief: checks if exists a client with given client name.
      * @return: true if there is client with this client name.
      */
-    bool _isClientExist( const std::string client);
+    bool _isClientExist( const std::string& client);
 
     /**
      * @brief: in case a client chose to unregister- the server removes
-     * it's name from the guests list of each event that he might have sent
-     * a RSVP request. events with empty guests list will remain.
+     * it's name from the guests list of each event that he sent a RSVP
+     * request to. events with empty guests list will remain.
+     */
+    void _removeClientFromEvents( NameId client,
+                                  const std::vector<int>& events);
+
+    /**
+     * @brief: run the complete requests of conn that are in its reader.
+     * @param atEOF: the client closed its side - the rest is the last line.
+     * @return: false on a protocol error.
+     */
+    static bool _runRequests( ClientConnection& conn, bool atEOF,
+                              ResponseQueue& responses);
+
+    /**
+     * @brief: write all the queued responses to the socket, handling short
+     * writes.
+     * @return: false on write error.
      */
-    void _removeClientFromEvents( const std::string client);
+    static bool _writeAll( int sock, ResponseQueue& responses);
 };
 
 #endif /* SERVER_H_ */
@@ -0,0 +1,53 @@
+/*
+ * StrRef.h
+ * Created on: Oct 17, 2026
+ * Author: nicole
+ */
+
+#ifndef STRREF_H_
+#define STRREF_H_
+
+#include <string.h> // memcmp
+#include <string>
+
+
+/**
+ * A slice of characters owned by someone else - a pointer and a length, as
+ * the C++17 std::string_view. a slice is copied without its characters, so
+ * a command line is split into slices of its own buffer with no allocation.
+ * a slice is valid only as long as the buffer it points into.
+ */
+struct StrRef
+{
+    const char* data;
+    size_t size;
+
+    StrRef(): data( ""), size( 0) {}
+
+    StrRef( const char* p, size_t len): data( p), size( len) {}
+
+    /* a slice of the whole string - valid while the string is unchanged */
+    StrRef( const std::string& s): data( s.data()), size( s.size()) {}
+
+    bool empty() const {
+        return size == 0;
+    }
+
+    /**
+     * @return: a copy of the characters - where a slice has to outlive
+     * its buffer.
+     */
+    std::string str() const {
+        return std::string( data, size);
+    }
+
+    bool operator==( const StrRef& other) const {
+        return size == other.size && memcmp( data, other.data, size) == 0;
+    }
+
+    bool operator!=( const StrRef& other) const {
+        return !(*this == other);
+    }
+};
+
+#endif /* STRREF_H_ */
@@ -0,0 +1,199 @@
+/*
+ * ThreadPool.cpp
+ * Created on: Oct 17, 2026
+ * Author: nicole
+ */
+
+#include "ThreadPool.h"
+
+/*************** Public Functions **************************************/
+
+/**
+ * @brief: Constructor - starts numWorkers threads. when numWorkers is 0
+ * the pool is sized to the number of cores.
+ */
+ThreadPool::ThreadPool( unsigned int numWorkers): _stop( false),
+        _pending( 0), _sleeping( 0), _nextQueue( 0), _submitted( 0),
+        _executed( 0), _steals( 0)
+{
+    unsigned int i;
+
+    if ( numWorkers == 0) {
+        numWorkers = std::thread::hardware_concurrency();
+    }
+    if ( numWorkers == 0) {
+        numWorkers = 1;
+    }
+
+    for ( i = 0; i < numWorkers; ++i) {
+        _queues.push_back( new WorkQueue());
+    }
+    for ( i = 0; i < numWorkers; ++i) {
+        _workers.push_back( std::thread( &ThreadPool::_workerLoop, this, i));
+    }
+}
+
+
+/**
+ * destructor - runs the jobs that are left and joins all the workers.
+ */
+ThreadPool::~ThreadPool()
+{
+    std::vector<WorkQueue*>::iterator it;
+
+    {
+        std::lock_guard<std::mutex> guard( _idleLock);
+        _stop = true;
+    }
+    _idleCond.notify_all();
+
+    std::for_each( _workers.begin(), _workers.end(),
+                   std::mem_fn( &std::thread::join));
+
+    for ( it = _queues.begin(); it != _queues.end(); ++it) {
+        delete *it;
+    }
+}
+
+
+/**
+ * @brief: add a job to the queue of the next worker. each submitting
+ * thread (an event loop) walks the queues round robin from its own start,
+ * so the loops share no counter. the idle lock is taken, and a worker
+ * woken, only when some worker sleeps - a busy pool finds the job by
+ * itself.
+ */
+void ThreadPool::submit( Job job)
+{
+    static thread_local size_t next = _nextQueue++;
+    WorkQueue* queue = _queues[next++ % _queues.size()];
+
+    /* counted before the push so a worker never sees a negative count */
+    _pending++;
+    {
+        std::lock_guard<std::mutex> guard( queue->lock);
+        queue->jobs.push_back( std::move( job));
+    }
+    _submitted++;
+
+    /* a worker counts itself sleeping before it checks _pending, and both
+     * are sequentially consistent - so either it sees the job or it is
+     * seen here. the lock keeps the wakeup from falling between its check
+     * and its wait */
+    if ( _sleeping > 0) {
+        {
+            std::lock_guard<std::mutex> guard( _idleLock);
+        }
+        _idleCond.notify_one();
+    }
+}
+
+
+/**
+ * @return: jobs waiting in all the queues.
+ */
+size_t ThreadPool::queueDepth()
+{
+    return _pending;
+}
+
+
+/**
+ * @return: pool statistics in format of:
+ * workers <n> queued <n> submitted <n> executed <n> steals <n>
+ * followed by the depth of each worker queue.
+ */
+std::string ThreadPool::stats()
+{
+    std::string statsStr;
+    std::vector<WorkQueue*>::iterator it;
+
+    statsStr = "workers " + std::to_string( _workers.size());
+    statsStr += " queued " + std::to_string( _pending);
+    statsStr += " submitted " + std::to_string( _submitted);
+    statsStr += " executed " + std::to_string( _executed);
+    statsStr += " steals " + std::to_string( _steals);
+    statsStr += " depths";
+
+    for ( it = _queues.begin(); it != _queues.end(); ++it) {
+        std::lock_guard<std::mutex> guard( (*it)->lock);
+        statsStr += " " + std::to_string( (*it)->jobs.size());
+    }
+
+    return statsStr;
+}
+
+/*************** Private Functions **************************************/
+
+/**
+ * @brief: worker main loop - run own jobs, then steal, then sleep.
+ */
+void ThreadPool::_workerLoop( unsigned int idx)
+{
+    Job job;
+
+    while ( true)
+    {
+        if ( _popLocal( idx, job) || _steal( idx, job)) {
+            _pending--;
+            job();
+            job = nullptr; /* release what the job captured */
+            _executed++;
+            continue;
+        }
+
+        std::unique_lock<std::mutex> guard( _idleLock);
+        _sleeping++;
+        _idleCond.wait( guard, [this] { return _stop || _pending > 0; });
+        _sleeping--;
+        if ( _stop && _pending == 0) {
+            return;
+        }
+    }
+}
+
+
+/**
+ * @brief: pop a job from the front of the worker own queue.
+ * @return: true if a job was found.
+ */
+bool ThreadPool::_popLocal( unsigned int idx, Job& job)
+{
+    WorkQueue* queue = _queues[idx];
+    std::lock_guard<std::mutex> guard( queue->lock);
+
+    if ( queue->jobs.empty()) {
+        return false;
+    }
+    job = std::move( queue->jobs.front());
+    queue->jobs.pop_front();
+    return true;
+}
+
+
+/**
+ * @brief: steal a job from the back of another worker queue.
+ * @return: true if a job was stolen.
+ */
+bool ThreadPool::_steal( unsigned int idx, Job& job)
+{
+    unsigned int i, victim;
+    WorkQueue* queue;
+
+    for ( i = 1; i < _queues.size(); ++i)
+    {
+        victim = (idx + i) % _queues.size();
+        queue = _queues[victim];
+
+        std::lock_guard<std::mutex> guard( queue->lock);
+        if ( queue->jobs.empty()) {
+            continue;
+        }
+        job = std::move( queue->jobs.back());
+        queue->jobs.pop_back();
+        _steals++;
+        return true;
+    }
+
+    return false;
+}
@@ -0,0 +1,112 @@
+/*
+ * ThreadPool.h
+ * Created on: Oct 17, 2026
+ * Author: nicole
+ */
+
+#ifndef THREADPOOL_H_
+#define THREADPOOL_H_
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <algorithm> // for_each
+
+/**
+ * A fixed size pool of worker threads. Each worker owns a deque of jobs, new
+ * jobs are spread round robin between the deques and an idle worker steals
+ * jobs from the other workers deques, so the number of threads (and the
+ * memory they use) stays constant no matter how many requests arrive.
+ */
+class ThreadPool
+{
+public:
+
+    typedef std::function<void()> Job;
+
+    /**
+     * @brief: Constructor - starts numWorkers threads. when numWorkers is 0
+     * the pool is sized to the number of cores.
+     */
+    ThreadPool( unsigned int numWorkers = 0);
+
+    /**
+     * destructor - runs the jobs that are left and joins all the workers.
+     */
+    virtual ~ThreadPool();
+
+    ThreadPool( ThreadPool const &other) = delete;
+    void operator=( ThreadPool const &other) = delete;
+
+    /**
+     * @brief: add a job to the queue of the next worker.
+     */
+    void submit( Job job);
+
+    /**
+     * @return: number of worker threads.
+     */
+    unsigned int size() const {
+        return _workers.size();
+    }
+
+    /**
+     * @return: jobs waiting in all the queues.
+     */
+    size_t queueDepth();
+
+    /**
+     * @return: pool statistics in format of:
+     * workers <n> queued <n> submitted <n> executed <n> steals <n>
+     * followed by the depth of each worker queue.
+     */
+    std::string stats();
+
+private:
+
+    /**
+     * a worker deque - guarded by its own lock so workers never contend
+     * unless one of them is stealing.
+     */
+    struct WorkQueue
+    {
+        std::mutex lock;
+        std::deque<Job> jobs;
+    };
+
+    std::vector<std::thread> _workers;
+    std::vector<WorkQueue*> _queues;
+    std::mutex _idleLock;
+    std::condition_variable _idleCond;
+    std::atomic<bool> _stop;
+    std::atomic<size_t> _pending;   /* jobs in all the queues */
+    std::atomic<size_t> _sleeping;  /* workers waiting on _idleCond */
+    std::atomic<size_t> _nextQueue; /* start queue of the next submitter */
+    std::atomic<size_t> _submitted;
+    std::atomic<size_t> _executed;
+    std::atomic<size_t> _steals;
+
+    /**
+     * @brief: worker main loop - run own jobs, then steal, then sleep.
+     */
+    void _workerLoop( unsigned int idx);
+
+    /**
+     * @brief: pop a job from the front of the worker own queue.
+     * @return: true if a job was found.
+     */
+    bool _popLocal( unsigned int idx, Job& job);
+
+    /**
+     * @brief: steal a job from the back of another worker queue.
+     * @return: true if a job was stolen.
+     */
+    bool _steal( unsigned int idx, Job& job);
+};
+
+#endif /* THREADPOOL_H_ */
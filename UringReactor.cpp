@@ -0,0 +1,790 @@
+/*
+ * UringReactor.cpp
+ * Created on: Oct 17, 2026
+ * Author: nicole
+ */
+
+#include "UringReactor.h"
+
+/* the request kind is kept in the low 3 bits of the user data, next to the
+ * (at least 8 bytes aligned) connection pointer */
+#define REQUEST_KIND_MASK 7ULL
+
+/**
+ * @brief: the io_uring system calls - there is no libc wrapper for them.
+ */
+static int ioUringSetup( unsigned entries, struct io_uring_params* params)
+{
+    return (int) syscall( __NR_io_uring_setup, entries, params);
+}
+
+static int ioUringEnter( int ringFD, unsigned toSubmit, unsigned minComplete,
+                         unsigned flags)
+{
+    return (int) syscall( __NR_io_uring_enter, ringFD, toSubmit, minComplete,
+                          flags, NULL, 0);
+}
+
+static int ioUringRegister( int ringFD, unsigned opcode, void* arg,
+                            unsigned numArgs)
+{
+    return (int) syscall( __NR_io_uring_register, ringFD, opcode, arg,
+                          numArgs);
+}
+
+
+/**
+ * @brief: the user data of a request of the given kind on conn.
+ */
+static uint64_t userData( void* conn, int kind)
+{
+    return (uint64_t) (uintptr_t) conn | (uint64_t) kind;
+}
+
+/*************** Public Functions **************************************/
+
+/**
+ * @brief: Constructor - takes the (already listening) master socket and
+ * the pool that executes the commands.
+ */
+UringReactor::UringReactor( int listenSock, ThreadPool* pool):
+        Reactor( listenSock, pool), _ringFD( -1), _sqRing( NULL),
+        _sqRingSize( 0), _sqHead( NULL), _sqTail( NULL), _sqMask( NULL),
+        _sqArray( NULL), _sqEntries( 0), _sqLocalTail( 0), _sqes( NULL),
+        _cqRing( NULL), _cqRingSize( 0), _cqHead( NULL), _cqTail( NULL),
+        _cqMask( NULL), _cqes( NULL), _bufs( NULL), _wakeCount( 0)
+{}
+
+
+/**
+ * destructor - tears down the rings and the provided buffers.
+ */
+UringReactor::~UringReactor()
+{
+    /* closing the ring cancels all the requests in flight */
+    if ( _ringFD >= 0) {
+        close( _ringFD);
+    }
+    if ( _sqes != NULL) {
+        munmap( _sqes, _sqEntries * sizeof(struct io_uring_sqe));
+    }
+    if ( _cqRing != NULL && _cqRing != _sqRing) {
+        munmap( _cqRing, _cqRingSize);
+    }
+    if ( _sqRing != NULL) {
+        munmap( _sqRing, _sqRingSize);
+    }
+    free( _bufs);
+}
+
+
+/**
+ * @brief: set up the io_uring instance, map its rings and provide the
+ * receive buffers.
+ * @return: false if the kernel lacks io_uring or a needed feature.
+ */
+bool UringReactor::init()
+{
+    struct io_uring_params params;
+    int flags;
+
+    if ( _wakeFD < 0) {
+        return false;
+    }
+
+    memset( &params, 0, sizeof(params));
+    /* completions are only needed when the loop waits for them */
+    params.flags = IORING_SETUP_COOP_TASKRUN;
+    _ringFD = ioUringSetup( URING_ENTRIES, &params);
+    if ( _ringFD < 0) {
+        Server::logServerError( "io_uring_setup", std::to_string( errno));
+        return false;
+    }
+
+    if ( !_mapRings( params) || !_probe() || !_provideBuffers() ||
+         !_probeMultishot()) {
+        return false;
+    }
+
+    /* io_uring honours O_NONBLOCK on a read - the wake read must wait */
+    flags = fcntl( _wakeFD, F_GETFL, 0);
+    if ( flags >= 0) {
+        fcntl( _wakeFD, F_SETFL, flags & ~O_NONBLOCK);
+    }
+    return true;
+}
+
+
+/**
+ * @brief: run the event loop until stop is called.
+ */
+void UringReactor::run()
+{
+    if ( _ringFD < 0) {
+        return;
+    }
+
+    _armAccept();
+    _armWake();
+
+    while ( _running)
+    {
+        /* submit everything queued by the last completions and wait - but
+         * not while the backlog waits for room in the submission queue */
+        _flushBacklog();
+        if ( _submit( _sqBacklog.empty() ? 1 : 0) < 0 && errno != EINTR &&
+             errno != EAGAIN && errno != EBUSY) {
+            Server::logServerError( "io_uring_enter", std::to_string( errno));
+            break;
+        }
+        _reapCompletions();
+        _resumeDrained();
+    }
+}
+
+/*************** Protected Functions **************************************/
+
+/**
+ * @brief: create the state of a newly accepted client socket.
+ */
+Reactor::Connection* UringReactor::_createConnection( int sock)
+{
+    return new UringConnection( sock);
+}
+
+
+/**
+ * @brief: send the pending response unless a send is in flight.
+ */
+void UringReactor::_writeConnection( Connection* conn)
+{
+    UringConnection* uconn = static_cast<UringConnection*>( conn);
+    struct io_uring_sqe* sqe;
+
+    if ( uconn->sending || conn->dead) {
+        return; /* continued when the send completes */
+    }
+
+    /* the kernel reads the queued segments until the send completes - the
+     * responses that arrive meanwhile are only appended behind them */
+    uconn->sendMsg.msg_iovlen = conn->out.gather( uconn->sendIov,
+                                                  MAX_WRITE_IOVS);
+    if ( uconn->sendMsg.msg_iovlen == 0) {
+        conn->out.consume( 0); /* drop the empty responses */
+        _writeDone( conn); /* may close the connection */
+        return;
+    }
+
+    sqe = _getSQE();
+    sqe->opcode = IORING_OP_SENDMSG;
+    sqe->fd = conn->sock;
+    sqe->addr = (uint64_t) (uintptr_t) &uconn->sendMsg;
+    sqe->len = 1;
+    sqe->msg_flags = MSG_NOSIGNAL;
+    sqe->user_data = userData( uconn, SEND_REQ);
+    uconn->sending = true;
+    uconn->inFlight++;
+}
+
+
+/**
+ * @brief: cancel the requests in flight of the connection that is being
+ * closed.
+ */
+void UringReactor::_detachConnection( Connection* conn)
+{
+    UringConnection* uconn = static_cast<UringConnection*>( conn);
+
+    /* the canceled requests complete with -ECANCELED, the connection is
+     * freed after the last one */
+    if ( uconn->receiving) {
+        _cancel( uconn, RECV_REQ);
+    }
+    if ( uconn->sending) {
+        _cancel( uconn, SEND_REQ);
+    }
+}
+
+
+/**
+ * @return: true if no request in flight refers to the connection.
+ */
+bool UringReactor::_released( Connection* conn)
+{
+    return static_cast<UringConnection*>( conn)->inFlight == 0;
+}
+
+
+/**
+ * @brief: cancel the receive of the connection that is being paused - the
+ * bytes of the receives that already completed are still taken.
+ */
+void UringReactor::_pauseInput( Connection* conn)
+{
+    UringConnection* uconn = static_cast<UringConnection*>( conn);
+
+    if ( uconn->receiving) {
+        _cancel( uconn, RECV_REQ);
+    }
+}
+
+
+/**
+ * @brief: queue the receive of the paused connection again - unless its
+ * canceled receive did not complete yet, that queues it when it does - and
+ * handle the requests already read.
+ */
+void UringReactor::_resumeInput( Connection* conn)
+{
+    UringConnection* uconn = static_cast<UringConnection*>( conn);
+
+    if ( !uconn->receiving && !uconn->peerClosed) {
+        _armRecv( uconn);
+    }
+    _inputReceived( conn); /* may close the connection */
+}
+
+/*************** Private Functions **************************************/
+
+/**
+ * @brief: check that the kernel supports all the operations in use.
+ * @return: false if an operation is missing.
+ */
+bool UringReactor::_probe()
+{
+    /* multishot accept and receive have no probe bit of their own - see
+     * _probeMultishot */
+    static const int needed[] = { IORING_OP_ACCEPT, IORING_OP_RECV,
+                                  IORING_OP_SENDMSG, IORING_OP_READ,
+                                  IORING_OP_PROVIDE_BUFFERS,
+                                  IORING_OP_ASYNC_CANCEL };
+    struct io_uring_probe* probe;
+    size_t size, i;
+    bool supported = true;
+
+    size = sizeof(struct io_uring_probe) +
+           IORING_OP_LAST * sizeof(struct io_uring_probe_op);
+    probe = (struct io_uring_probe*) calloc( 1, size);
+    if ( probe == NULL) {
+        return false;
+    }
+
+    if ( ioUringRegister( _ringFD, IORING_REGISTER_PROBE, probe,
+                          IORING_OP_LAST) < 0) {
+        Server::logServerError( "io_uring_register", std::to_string( errno));
+        free( probe);
+        return false;
+    }
+
+    for ( i = 0; i < sizeof(needed) / sizeof(needed[0]); ++i)
+    {
+        if ( needed[i] > probe->last_op ||
+             !(probe->ops[needed[i]].flags & IO_URING_OP_SUPPORTED)) {
+            Server::logServerError( "io_uring_probe",
+                    "operation " + std::to_string( needed[i]) +
+                    " is not supported");
+            supported = false;
+        }
+    }
+
+    free( probe);
+    return supported;
+}
+
+
+/**
+ * @brief: check that the kernel keeps a multishot receive armed - there is
+ * no probe bit for it. a receive on a socket pair that holds a byte and the
+ * end of file completes the byte with IORING_CQE_F_MORE on kernels that
+ * support it, and with -EINVAL (or as a single shot) on older ones. the
+ * multishot accept came before the multishot receive.
+ * @return: false if the multishot receive is not supported.
+ */
+bool UringReactor::_probeMultishot()
+{
+    struct io_uring_sqe* sqe;
+    uint64_t data;
+    uint32_t flags;
+    int sv[2];
+    int res, pending = 1;
+    bool supported = false;
+
+    if ( socketpair( AF_UNIX, SOCK_STREAM, 0, sv) < 0) {
+        Server::logServerError( "socketpair", std::to_string( errno));
+        return false;
+    }
+    if ( write( sv[1], "", 1) != 1 || shutdown( sv[1], SHUT_WR) < 0) {
+        Server::logServerError( "write", std::to_string( errno));
+        close( sv[0]);
+        close( sv[1]);
+        return false;
+    }
+
+    sqe = _getSQE();
+    sqe->opcode = IORING_OP_RECV;
+    sqe->fd = sv[0];
+    sqe->ioprio = IORING_RECV_MULTISHOT;
+    sqe->flags = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = URING_BUFFER_GROUP;
+    sqe->user_data = userData( NULL, RECV_REQ);
+
+    /* wait for the last completion of the receive, and of the buffers it
+     * hands back */
+    while ( pending > 0)
+    {
+        if ( _submit( 1) < 0) {
+            if ( errno == EINTR) {
+                continue;
+            }
+            Server::logServerError( "io_uring_enter", std::to_string( errno));
+            supported = false;
+            break;
+        }
+
+        while ( pending > 0 && _nextCompletion( data, res, flags))
+        {
+            pending--;
+            if ( (data & REQUEST_KIND_MASK) != RECV_REQ) {
+                continue; /* a buffer was handed back */
+            }
+            if ( flags & IORING_CQE_F_BUFFER) {
+                _queueBuffers( flags >> IORING_CQE_BUFFER_SHIFT, 1);
+                pending++;
+            }
+            if ( flags & IORING_CQE_F_MORE) {
+                supported = true;
+                pending++;
+            }
+        }
+    }
+
+    close( sv[0]);
+    close( sv[1]);
+    if ( !supported) {
+        Server::logServerError( "io_uring_probe",
+                                "multishot receive is not supported");
+    }
+    return supported;
+}
+
+
+/**
+ * @brief: map the submission and completion rings.
+ * @return: false on failure.
+ */
+bool UringReactor::_mapRings( const struct io_uring_params& params)
+{
+    char* sq;
+    char* cq;
+
+    _sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    _cqRingSize = params.cq_off.cqes +
+                  params.cq_entries * sizeof(struct io_uring_cqe);
+    /* newer kernels map both rings with one mmap call */
+    if ( params.features & IORING_FEAT_SINGLE_MMAP) {
+        if ( _cqRingSize > _sqRingSize) {
+            _sqRingSize = _cqRingSize;
+        }
+        _cqRingSize = _sqRingSize;
+    }
+
+    _sqRing = mmap( NULL, _sqRingSize, PROT_READ | PROT_WRITE,
+                    MAP_SHARED | MAP_POPULATE, _ringFD, IORING_OFF_SQ_RING);
+    if ( _sqRing == MAP_FAILED) {
+        _sqRing = NULL;
+        Server::logServerError( "mmap", std::to_string( errno));
+        return false;
+    }
+
+    if ( params.features & IORING_FEAT_SINGLE_MMAP) {
+        _cqRing = _sqRing;
+    } else {
+        _cqRing = mmap( NULL, _cqRingSize, PROT_READ | PROT_WRITE,
+                        MAP_SHARED | MAP_POPULATE, _ringFD,
+                        IORING_OFF_CQ_RING);
+        if ( _cqRing == MAP_FAILED) {
+            _cqRing = NULL;
+            Server::logServerError( "mmap", std::to_string( errno));
+            return false;
+        }
+    }
+
+    _sqEntries = params.sq_entries;
+    _sqes = (struct io_uring_sqe*) mmap( NULL,
+                    _sqEntries * sizeof(struct io_uring_sqe),
+                    PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                    _ringFD, IORING_OFF_SQES);
+    if ( _sqes == MAP_FAILED) {
+        _sqes = NULL;
+        Server::logServerError( "mmap", std::to_string( errno));
+        return false;
+    }
+
+    sq = (char*) _sqRing;
+    _sqHead = (unsigned*) (sq + params.sq_off.head);
+    _sqTail = (unsigned*) (sq + params.sq_off.tail);
+    _sqMask = (unsigned*) (sq + params.sq_off.ring_mask);
+    _sqArray = (unsigned*) (sq + params.sq_off.array);
+    _sqLocalTail = *_sqTail;
+
+    cq = (char*) _cqRing;
+    _cqHead = (unsigned*) (cq + params.cq_off.head);
+    _cqTail = (unsigned*) (cq + params.cq_off.tail);
+    _cqMask = (unsigned*) (cq + params.cq_off.ring_mask);
+    _cqes = (struct io_uring_cqe*) (cq + params.cq_off.cqes);
+    return true;
+}
+
+
+/**
+ * @brief: allocate the receive buffers and provide them to the kernel.
+ * @return: false on failure.
+ */
+bool UringReactor::_provideBuffers()
+{
+    uint64_t data;
+    uint32_t flags;
+    int res;
+
+    _bufs = (char*) malloc( URING_RECV_BUFFERS * URING_RECV_BUFFER_LEN);
+    if ( _bufs == NULL) {
+        return false;
+    }
+
+    _queueBuffers( 0, URING_RECV_BUFFERS);
+    if ( _submit( 1) < 0) {
+        Server::logServerError( "io_uring_enter", std::to_string( errno));
+        return false;
+    }
+
+    /* nothing else is in flight yet - this is its completion */
+    if ( !_nextCompletion( data, res, flags)) {
+        return false;
+    }
+    if ( res < 0) {
+        Server::logServerError( "io_uring_provide_buffers",
+                                std::to_string( -res));
+        return false;
+    }
+    return true;
+}
+
+
+/**
+ * @brief: queue the request that provides count buffers, starting with
+ * bufferId, to the kernel.
+ */
+void UringReactor::_queueBuffers( unsigned bufferId, unsigned count)
+{
+    struct io_uring_sqe* sqe = _getSQE();
+
+    sqe->opcode = IORING_OP_PROVIDE_BUFFERS;
+    sqe->fd = count;
+    sqe->addr = (uint64_t) (uintptr_t) (_bufs +
+                                        bufferId * URING_RECV_BUFFER_LEN);
+    sqe->len = URING_RECV_BUFFER_LEN;
+    sqe->off = bufferId;
+    sqe->buf_group = URING_BUFFER_GROUP;
+    sqe->user_data = userData( NULL, BUFFER_REQ);
+}
+
+
+/**
+ * @return: true if the submission queue has no free entry.
+ */
+bool UringReactor::_sqFull() const
+{
+    return _sqLocalTail - __atomic_load_n( _sqHead, __ATOMIC_ACQUIRE) >=
+           _sqEntries;
+}
+
+
+/**
+ * @brief: get a cleared submission entry, submitting the queued ones if
+ * the queue is full. the kernel may take only part of them - or none,
+ * while its completion queue is backed up - so an entry that still does
+ * not fit is queued in the backlog, behind the older backlog entries,
+ * instead of overwriting an entry the kernel did not consume yet. the
+ * loop moves the backlog to the queue once the completions are reaped.
+ */
+struct io_uring_sqe* UringReactor::_getSQE()
+{
+    struct io_uring_sqe* sqe;
+    unsigned index;
+
+    if ( _sqBacklog.empty() && _sqFull()) {
+        _submit( 0);
+    }
+    if ( !_sqBacklog.empty() || _sqFull()) {
+        /* the deque keeps the entries in place as it grows */
+        _sqBacklog.push_back( io_uring_sqe());
+        return &_sqBacklog.back();
+    }
+
+    index = _sqLocalTail & *_sqMask;
+    sqe = &_sqes[index];
+    memset( sqe, 0, sizeof(*sqe));
+    _sqArray[index] = index;
+    _sqLocalTail++;
+    return sqe;
+}
+
+
+/**
+ * @brief: move the backlog entries to the submission queue, as far as it
+ * has room.
+ */
+void UringReactor::_flushBacklog()
+{
+    unsigned index;
+
+    while ( !_sqBacklog.empty() && !_sqFull())
+    {
+        index = _sqLocalTail & *_sqMask;
+        _sqes[index] = _sqBacklog.front();
+        _sqArray[index] = index;
+        _sqLocalTail++;
+        _sqBacklog.pop_front();
+    }
+}
+
+
+/**
+ * @brief: submit the queued entries and wait for at least waitFor
+ * completions - one io_uring_enter call.
+ * @return: the system call result.
+ */
+int UringReactor::_submit( unsigned waitFor)
+{
+    unsigned toSubmit;
+
+    /* publish the queued entries to the kernel */
+    __atomic_store_n( _sqTail, _sqLocalTail, __ATOMIC_RELEASE);
+    toSubmit = _sqLocalTail - __atomic_load_n( _sqHead, __ATOMIC_ACQUIRE);
+
+    if ( toSubmit == 0 && waitFor == 0) {
+        return 0;
+    }
+    return ioUringEnter( _ringFD, toSubmit, waitFor,
+                         waitFor > 0 ? IORING_ENTER_GETEVENTS : 0);
+}
+
+
+/**
+ * @brief: take the next completion out of the completion queue.
+ * @return: false if the queue is empty.
+ */
+bool UringReactor::_nextCompletion( uint64_t& data, int& res, uint32_t& flags)
+{
+    struct io_uring_cqe* cqe;
+    unsigned head = *_cqHead;
+
+    if ( head == __atomic_load_n( _cqTail, __ATOMIC_ACQUIRE)) {
+        return false;
+    }
+
+    cqe = &_cqes[head & *_cqMask];
+    data = cqe->user_data;
+    res = cqe->res;
+    flags = cqe->flags;
+
+    /* the entry is copied - hand it back before handling it */
+    __atomic_store_n( _cqHead, head + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+
+/**
+ * @brief: handle all the completions in the completion queue.
+ */
+void UringReactor::_reapCompletions()
+{
+    uint64_t data;
+    int res;
+    uint32_t flags;
+    UringConnection* conn;
+
+    while ( _nextCompletion( data, res, flags))
+    {
+        conn = (UringConnection*) (uintptr_t) (data & ~REQUEST_KIND_MASK);
+        switch ( data & REQUEST_KIND_MASK)
+        {
+            case ACCEPT_REQ:
+                _onAccept( res, flags);
+                break;
+
+            case WAKE_REQ:
+                _collectResponses();
+                _armWake();
+                break;
+
+            case RECV_REQ:
+                _onRecv( conn, res, flags);
+                break;
+
+            case SEND_REQ:
+                _onSend( conn, res);
+                break;
+
+            case BUFFER_REQ:
+                if ( res < 0) {
+                    Server::logServerError( "io_uring_provide_buffers",
+                                            std::to_string( -res));
+                }
+                break;
+
+            default: /* CANCEL_REQ */
+                break;
+        }
+    }
+}
+
+
+/**
+ * @brief: queue the multishot accept on the master socket.
+ */
+void UringReactor::_armAccept()
+{
+    struct io_uring_sqe* sqe = _getSQE();
+
+    sqe->opcode = IORING_OP_ACCEPT;
+    sqe->fd = _listenSock;
+    sqe->ioprio = IORING_ACCEPT_MULTISHOT;
+    sqe->user_data = userData( NULL, ACCEPT_REQ);
+}
+
+
+/**
+ * @brief: queue the read of the wake eventfd.
+ */
+void UringReactor::_armWake()
+{
+    struct io_uring_sqe* sqe = _getSQE();
+
+    sqe->opcode = IORING_OP_READ;
+    sqe->fd = _wakeFD;
+    sqe->addr = (uint64_t) (uintptr_t) &_wakeCount;
+    sqe->len = sizeof(_wakeCount);
+    sqe->user_data = userData( NULL, WAKE_REQ);
+}
+
+
+/**
+ * @brief: queue the multishot receive of the connection.
+ */
+void UringReactor::_armRecv( UringConnection* conn)
+{
+    struct io_uring_sqe* sqe = _getSQE();
+
+    sqe->opcode = IORING_OP_RECV;
+    sqe->fd = conn->sock;
+    sqe->ioprio = IORING_RECV_MULTISHOT;
+    sqe->flags = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = URING_BUFFER_GROUP;
+    sqe->user_data = userData( conn, RECV_REQ);
+    conn->receiving = true;
+    conn->inFlight++;
+}
+
+
+/**
+ * @brief: queue the cancel of the request of the given kind on conn.
+ */
+void UringReactor::_cancel( UringConnection* conn, int kind)
+{
+    struct io_uring_sqe* sqe = _getSQE();
+
+    sqe->opcode = IORING_OP_ASYNC_CANCEL;
+    sqe->fd = -1;
+    sqe->addr = userData( conn, kind);
+    sqe->user_data = userData( NULL, CANCEL_REQ);
+}
+
+
+/**
+ * @brief: a connection was accepted.
+ */
+void UringReactor::_onAccept( int res, uint32_t flags)
+{
+    if ( !(flags & IORING_CQE_F_MORE)) {
+        _armAccept(); /* the kernel ended the multishot accept */
+    }
+
+    if ( res < 0) {
+        Server::logServerError( "accept", std::to_string( -res));
+        return;
+    }
+
+    _armRecv( static_cast<UringConnection*>( _addConnection( res)));
+}
+
+
+/**
+ * @brief: bytes (or end of file) were received on a connection.
+ */
+void UringReactor::_onRecv( UringConnection* conn, int res, uint32_t flags)
+{
+    unsigned bufferId;
+    bool more = (flags & IORING_CQE_F_MORE) != 0;
+
+    if ( flags & IORING_CQE_F_BUFFER) {
+        bufferId = flags >> IORING_CQE_BUFFER_SHIFT;
+        if ( res > 0) {
+            conn->reader.append( _bufs + bufferId * URING_RECV_BUFFER_LEN,
+                                 res);
+        }
+        _queueBuffers( bufferId, 1); /* the bytes are copied - hand it back */
+    }
+
+    /* this receive still refers to conn, so it is not freed meanwhile */
+    if ( !conn->dead) {
+        if ( res == 0) {
+            conn->peerClosed = true;
+            _inputReceived( conn);
+        } else if ( res > 0) {
+            _inputReceived( conn);
+        } else if ( res != -ENOBUFS && res != -ECANCELED) {
+            _closeConnection( conn);
+        }
+    }
+
+    if ( more && !conn->dead && _backlogged( conn)) {
+        _pause( conn); /* stop receiving until the backlog drains */
+    }
+
+    if ( more) {
+        return;
+    }
+
+    /* the multishot receive ended */
+    conn->receiving = false;
+    conn->inFlight--;
+    if ( conn->dead) {
+        _freeConnection( conn);
+    } else if ( res != 0 && !conn->paused) {
+        _armRecv( conn); /* out of buffers - or the kernel stopped it */
+    }
+}
+
+
+/**
+ * @brief: a send of a connection completed.
+ */
+void UringReactor::_onSend( UringConnection* conn, int res)
+{
+    conn->sending = false;
+    conn->inFlight--;
+
+    if ( conn->dead) {
+        _freeConnection( conn);
+        return;
+    }
+
+    if ( res < 0) {
+        _closeConnection( conn);
+        return;
+    }
+
+    conn->out.consume( res);
+    _writeConnection( conn); /* the rest, the next responses or close */
+}
@@ -0,0 +1,250 @@
+/*
+ * UringReactor.h
+ * Created on: Oct 17, 2026
+ * Author: nicole
+ */
+
+#ifndef URINGREACTOR_H_
+#define URINGREACTOR_H_
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <deque>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+
+#include "Reactor.h"
+
+/* number of submission queue entries (the completion queue is twice that) */
+#define URING_ENTRIES 256
+/* number of provided receive buffers */
+#define URING_RECV_BUFFERS 256
+/* size of each provided receive buffer */
+#define URING_RECV_BUFFER_LEN READ_CHUNK
+/* id of the provided buffers group used by all the receives */
+#define URING_BUFFER_GROUP 0
+
+
+/**
+ * An io_uring event loop, driven by the raw system calls. The master socket
+ * is served by one multishot accept, each client socket by one multishot
+ * receive that picks its buffers from a group of buffers provided to the
+ * kernel up front (and handed back once their bytes are copied), and the
+ * queued responses are sent asynchronously with one gathering sendmsg. all
+ * the requests queued in one loop iteration are submitted together with
+ * the wait for completions - one system call per iteration. init() fails
+ * on kernels that lack any of these features, so the server can fall back
+ * to epoll.
+ */
+class UringReactor: public Reactor
+{
+public:
+
+    /**
+     * @brief: Constructor - takes the (already listening) master socket and
+     * the pool that executes the commands.
+     */
+    UringReactor( int listenSock, ThreadPool* pool);
+
+    /**
+     * destructor - tears down the rings and the provided buffers.
+     */
+    virtual ~UringReactor();
+
+    /**
+     * @brief: set up the io_uring instance, map its rings and provide the
+     * receive buffers.
+     * @return: false if the kernel lacks io_uring or a needed feature.
+     */
+    virtual bool init();
+
+    /**
+     * @brief: run the event loop until stop is called.
+     */
+    virtual void run();
+
+protected:
+
+    /**
+     * client connection with the state of its requests in flight.
+     */
+    struct UringConnection: public Connection
+    {
+        struct iovec sendIov[MAX_WRITE_IOVS]; /* the out bytes being sent */
+        struct msghdr sendMsg;
+        bool sending;        /* a send request is in flight */
+        bool receiving;      /* the multishot receive is in flight */
+        int inFlight;        /* requests in flight that refer to it */
+
+        UringConnection( int sockFD): Connection( sockFD), sending( false),
+                receiving( false), inFlight( 0)
+        {
+            memset( &sendMsg, 0, sizeof(sendMsg));
+            sendMsg.msg_iov = sendIov;
+        }
+    };
+
+    /**
+     * @brief: create the state of a newly accepted client socket.
+     */
+    virtual Connection* _createConnection( int sock);
+
+    /**
+     * @brief: send the pending response unless a send is in flight.
+     */
+    virtual void _writeConnection( Connection* conn);
+
+    /**
+     * @brief: cancel the requests in flight of the connection that is being
+     * closed.
+     */
+    virtual void _detachConnection( Connection* conn);
+
+    /**
+     * @return: true if no request in flight refers to the connection.
+     */
+    virtual bool _released( Connection* conn);
+
+    /**
+     * @brief: cancel the receive of the connection that is being paused.
+     */
+    virtual void _pauseInput( Connection* conn);
+
+    /**
+     * @brief: queue the receive of the paused connection again.
+     */
+    virtual void _resumeInput( Connection* conn);
+
+private:
+
+    /* kind of request, kept in the low bits of the request user data */
+    enum RequestKind { ACCEPT_REQ = 1, WAKE_REQ, RECV_REQ, SEND_REQ,
+                       BUFFER_REQ, CANCEL_REQ };
+
+    int _ringFD;
+    /* submission queue ring */
+    void* _sqRing;
+    size_t _sqRingSize;
+    unsigned* _sqHead;
+    unsigned* _sqTail;
+    unsigned* _sqMask;
+    unsigned* _sqArray;
+    unsigned _sqEntries;
+    unsigned _sqLocalTail; /* entries queued, published on submit */
+    struct io_uring_sqe* _sqes;
+    /* entries queued while the submission queue was full, in order */
+    std::deque<struct io_uring_sqe> _sqBacklog;
+    /* completion queue ring */
+    void* _cqRing;
+    size_t _cqRingSize;
+    unsigned* _cqHead;
+    unsigned* _cqTail;
+    unsigned* _cqMask;
+    struct io_uring_cqe* _cqes;
+    char* _bufs;  /* provided receive buffers */
+
+    uint64_t _wakeCount;  /* read target of the wake eventfd */
+
+    /**
+     * @brief: check that the kernel supports all the operations in use.
+     * @return: false if an operation is missing.
+     */
+    bool _probe();
+
+    /**
+     * @brief: check that the kernel keeps a multishot receive armed.
+     * @return: false if the multishot receive is not supported.
+     */
+    bool _probeMultishot();
+
+    /**
+     * @brief: map the submission and completion rings.
+     * @return: false on failure.
+     */
+    bool _mapRings( const struct io_uring_params& params);
+
+    /**
+     * @brief: allocate the receive buffers and provide them to the kernel.
+     * @return: false on failure.
+     */
+    bool _provideBuffers();
+
+    /**
+     * @brief: queue the request that provides count buffers, starting with
+     * bufferId, to the kernel.
+     */
+    void _queueBuffers( unsigned bufferId, unsigned count);
+
+    /**
+     * @return: true if the submission queue has no free entry.
+     */
+    bool _sqFull() const;
+
+    /**
+     * @brief: get a cleared submission entry, submitting the queued ones if
+     * the queue is full - or a backlog entry if it is still full.
+     */
+    struct io_uring_sqe* _getSQE();
+
+    /**
+     * @brief: move the backlog entries to the submission queue, as far as
+     * it has room.
+     */
+    void _flushBacklog();
+
+    /**
+     * @brief: submit the queued entries and wait for at least waitFor
+     * completions - one io_uring_enter call.
+     * @return: the system call result.
+     */
+    int _submit( unsigned waitFor);
+
+    /**
+     * @brief: take the next completion out of the completion queue.
+     * @return: false if the queue is empty.
+     */
+    bool _nextCompletion( uint64_t& data, int& res, uint32_t& flags);
+
+    /**
+     * @brief: handle all the completions in the completion queue.
+     */
+    void _reapCompletions();
+
+    /**
+     * @brief: queue the multishot accept on the master socket.
+     */
+    void _armAccept();
+
+    /**
+     * @brief: queue the read of the wake eventfd.
+     */
+    void _armWake();
+
+    /**
+     * @brief: queue the multishot receive of the connection.
+     */
+    void _armRecv( UringConnection* conn);
+
+    /**
+     * @brief: queue the cancel of the request of the given kind on conn.
+     */
+    void _cancel( UringConnection* conn, int kind);
+
+    /**
+     * @brief: a connection was accepted.
+     */
+    void _onAccept( int res, uint32_t flags);
+
+    /**
+     * @brief: bytes (or end of file) were received on a connection.
+     */
+    void _onRecv( UringConnection* conn, int res, uint32_t flags);
+
+    /**
+     * @brief: a send of a connection completed.
+     */
+    void _onSend( UringConnection* conn, int res);
+};
+
+#endif /* URINGREACTOR_H_ */
@@ -20,12 +20,16 @@
 #include <vector>
 #include <iostream>  // std::cout
 #include <errno.h>
+#include <poll.h>
 extern int h_errno;
 
 #include "Client.h"
+#include "RequestReader.h"
+#include "BinaryProtocol.h"
 #define MAX_CLIENTNAME 10
 #define TRUE 1
 #define MAXLEN 99999
+#define USAGE "Usage: emClient clientName serverAddress serverPort [-s] [-p depth] [-b]"
 // N.B.O – network bytes order
 
 /**
@@ -39,20 +43,247 @@ void clientSystemCallError( Client* client, const char *func, int errCode)
 {
     std::string errStr;
     std::string funcSys( func);
-    errStr = "ERROR" + '\t' + funcSys+ '\t' + std::to_string(errCode);
+    errStr = "ERROR\t" + funcSys + '\t' + std::to_string(errCode);
     client->logToClient( errStr);
     exit(1);
 }
 
 
+/**
+ * @brief: take one framed response: <response length>\n<response> out of
+ * the bytes read from the session socket.
+ * @return: false if there is no complete response yet.
+ */
+bool takeFramedResponse( RequestReader& responses, std::string& response)
+{
+    const char* data = responses.peek();
+    const char* headerEnd;
+    size_t length, headerLen;
+
+    headerEnd = (const char*) memchr( data, '\n', responses.available());
+    if ( headerEnd == NULL) {
+        return false;
+    }
+
+    /* strtoul stops at the new line */
+    length = strtoul( data, NULL, 10);
+    headerLen = headerEnd - data + 1;
+    if ( responses.available() < headerLen + length) {
+        return false;
+    }
+
+    response.assign( headerEnd + 1, length);
+    responses.consume( headerLen + length);
+    return true;
+}
+
+
+/**
+ * @brief: write all of the data to the socket, handling short writes.
+ * @return: false on write error.
+ */
+bool writeAll( int sockFD, const std::string& data)
+{
+    size_t offset = 0;
+    ssize_t n;
+
+    while ( offset < data.size())
+    {
+        n = write( sockFD, data.data() + offset, data.size() - offset);
+        if ( n < 0 && errno == EINTR) {
+            continue;
+        }
+        if ( n < 0) {
+            return false;
+        }
+        offset += n;
+    }
+    return true;
+}
+
+
+/**
+ * @brief: connect a new socket to the server.
+ * @return: the connected socket.
+ */
+int connectServer( Client* client, struct sockaddr_in& serv_addr)
+{
+    int sockFD = socket( AF_INET, SOCK_STREAM, 0);
+    if ( sockFD < 0)
+    {
+        clientSystemCallError( client, "socket", sockFD);
+    }
+    /* called by the client to establish a connection to the server*/
+    int res = connect( sockFD,(struct sockaddr *) &serv_addr,
+                       sizeof(serv_addr));
+    if (res < 0)
+    {
+        clientSystemCallError( client, "connect", res);
+    }
+    return sockFD;
+}
+
+
+/**
+ * @brief: validate the command line and queue it in request if valid.
+ * @return: true if it was queued.
+ */
+bool queueCommand( Client* client, const std::string& line,
+                   std::string& request, bool binary)
+{
+    static uint32_t requestId = 0;
+
+    if ( !client->validateCommand( line.c_str())) {
+        return false;
+    }
+    if ( binary) {
+        request += BinaryProtocol::encodeRequest( client->getCommandType(),
+                                ++requestId, client->getCommandArgs());
+    } else {
+        request += line + "\n";
+    }
+    client->commandSent();
+    return true;
+}
+
+
+/**
+ * @brief: validate the typed commands already read from stdin and queue the
+ * valid ones in request, as long as less than depth commands wait for a
+ * response.
+ */
+void queueCommands( Client* client, RequestReader& commands, bool stdinEOF,
+                    size_t depth, size_t& outstanding, std::string& request,
+                    bool binary)
+{
+    std::string line;
+
+    while ( outstanding < depth && commands.nextLine( line, stdinEOF))
+    {
+        if ( queueCommand( client, line, request, binary)) {
+            outstanding++;
+        }
+    }
+}
+
+
+/**
+ * @brief: read the session socket and log each complete response. the next
+ * page of a RSVP list page is queued in request in place of the page.
+ */
+void readResponses( Client* client, int sockFD, RequestReader& responses,
+                    size_t& outstanding, std::string& request, bool binary)
+{
+    std::string response, nextPage;
+    BinaryHeader header;
+    ssize_t n;
+
+    n = responses.fill( sockFD);
+    if ( n <= 0) {
+        clientSystemCallError( client, "read", errno);
+    }
+
+    while ( outstanding > 0)
+    {
+        if ( binary) {
+            if ( BinaryProtocol::takeFrame( responses, header, response) != 1) {
+                return;
+            }
+            outstanding--;
+            client->log_binary_response( header.status, response);
+        } else {
+            if ( !takeFramedResponse( responses, response)) {
+                return;
+            }
+            outstanding--;
+            /* log server response in client log */
+            client->log_response( response);
+        }
+
+        if ( client->takeNextPage( nextPage) &&
+             queueCommand( client, nextPage, request, binary)) {
+            outstanding++;
+        }
+    }
+}
+
+
+/**
+ * @brief: session mode - connect once, send the client name once and then
+ * send each typed command on the same connection. up to depth commands are
+ * sent (pipelined) without waiting for their responses, which arrive in the
+ * order the commands were sent.
+ */
+void runSession( Client* client, struct sockaddr_in& serv_addr, size_t depth,
+                 bool binary)
+{
+    std::string request;
+    RequestReader commands, responses;
+    bool stdinEOF = false;
+    size_t outstanding = 0;
+    struct pollfd fds[2];
+    ssize_t n;
+    int sockFD = connectServer( client, serv_addr);
+
+    request = (binary ? BINARY_SESSION_COMMAND : SESSION_COMMAND);
+    request += client->clientName + "\n";
+    if ( !writeAll( sockFD, request)) {
+        clientSystemCallError( client, "write", errno);
+    }
+    request.clear();
+
+    while ( !stdinEOF || outstanding > 0)
+    {
+        /* stop reading commands while the pipeline is full */
+        fds[0].fd = (!stdinEOF && outstanding < depth) ? STDIN_FILENO : -1;
+        fds[0].events = POLLIN;
+        fds[1].fd = sockFD;
+        fds[1].events = POLLIN;
+
+        if ( poll( fds, 2, -1) < 0) {
+            if ( errno == EINTR) {
+                continue;
+            }
+            clientSystemCallError( client, "poll", errno);
+        }
+
+        if ( fds[0].revents & (POLLIN | POLLHUP)) {
+            n = commands.fill( STDIN_FILENO);
+            if ( n <= 0) {
+                stdinEOF = true;
+            }
+        }
+
+        if ( fds[1].revents & (POLLIN | POLLHUP | POLLERR)) {
+            readResponses( client, sockFD, responses, outstanding, request,
+                           binary);
+        }
+
+        queueCommands( client, commands, stdinEOF, depth, outstanding,
+                       request, binary);
+        if ( !request.empty()) {
+            if ( !writeAll( sockFD, request)) {
+                clientSystemCallError( client, "write", errno);
+            }
+            request.clear();
+        }
+    }
+
+    close( sockFD);
+}
+
+
 /* client main
  * Start the server first.
  * To run the client you need to pass in two arguments, the name of the host
  * on which the server is running and the port number on which the server
  * is listening for connections.
  * The command line to connect to the server described above:
- * ./emClient clientName serverAddress serverPort :
- * ./emClient nicole 127.0.0.1 1024 */
+ * ./emClient clientName serverAddress serverPort [-s] [-p depth] [-b] :
+ * ./emClient nicole 127.0.0.1 1024
+ * with -s all the commands are sent on one persistent session connection,
+ * -p also pipelines up to depth commands on the session and -b uses the
+ * binary protocol on the session. */
 int main( int argc, char *argv[])
 {
     /*sockfd is file descriptors, i.e. array subscripts into
@@ -74,79 +305,109 @@ int main( int argc, char *argv[])
     char requestBuff[MAXLEN];
     char responseBuff[MAXLEN];
     std::string clientname;
-    std::string request;
+    std::string request, nextPage;
     Client* client;
+    size_t received;
     bool isValidCommand;
+    bool sessionMode = false;
+    bool binary = false;
+    size_t depth = 1;
+    int opt;
+
+    while ( (opt = getopt( argc, argv, "sp:b")) != -1)
+    {
+        if ( opt == 's') {
+            sessionMode = true;
+        } else if ( opt == 'b') {
+            sessionMode = true;
+            binary = true;
+        } else if ( opt == 'p' && atoi( optarg) > 0) {
+            sessionMode = true;
+            depth = atoi( optarg);
+        } else {
+            fprintf( stdout, USAGE);
+            exit(1);
+        }
+    }
 
-    if ( argc < 3) {
-        fprintf( stdout,"Usage: emClient clientName serverAddress serverPort");
+    if ( argc - optind < 3) {
+        fprintf( stdout, USAGE);
         exit(1);
     }
 
     memset( &serv_addr, 0, sizeof(struct sockaddr_in));
-    clientname = std::string( argv[1]);
+    clientname = std::string( argv[optind]);
     client = new Client( clientname);
 
     /*gethostbyname returns a struct hostent named server */
-    server = gethostbyname( argv[2]);
+    server = gethostbyname( argv[optind + 1]);
     if ( !server) {
         clientSystemCallError( client, "gethostbyname", h_errno);
     }
 
-    portNum = atoi( argv[3]);
+    portNum = atoi( argv[optind + 2]);
     serv_addr.sin_family = AF_INET;
     serv_addr.sin_port = htons( (u_short) portNum);
 
     memcpy((char *)&serv_addr.sin_addr,(char *)server->h_addr,server->h_length);
 
+    if ( sessionMode) {
+        runSession( client, serv_addr, depth, binary);
+        delete client;
+        return 0;
+    }
 
     while (TRUE)
     {
         memset( userCommandBuff, 0, MAXLEN); // init buffer with 0
         memset( requestBuff, 0, MAXLEN);
 
-        fgets( userCommandBuff, MAXLEN-1, stdin);
+        if ( fgets( userCommandBuff, MAXLEN-1, stdin) == NULL) {
+            break; /* end of the commands */
+        }
 
         isValidCommand = client->validateCommand( userCommandBuff);
-        if (isValidCommand)
+        /* a RSVP list page is followed by its next pages */
+        while (isValidCommand)
         {
-            sockFD = socket( AF_INET, SOCK_STREAM, 0);
-            if ( sockFD < 0)
-            {
-                clientSystemCallError( client, "socket", sockFD);
-            }
-            /* called by the client to establish a connection to the server*/
-            int res = connect( sockFD,(struct sockaddr *) &serv_addr,
-                               sizeof(serv_addr));
-            if (res < 0)
-            {
-                clientSystemCallError( client, "connect", res);
-            } else {
-                strcpy( requestBuff, clientname.c_str());
-                strncat(requestBuff, "\n", strlen("\n"));
-                strncat(requestBuff, userCommandBuff, strlen(userCommandBuff));
+            sockFD = connectServer( client, serv_addr);
+            client->commandSent();
 
-                /* write client request to the socket */
+            strcpy( requestBuff, clientname.c_str());
+            strcat( requestBuff, "\n");
+            strncat(requestBuff, userCommandBuff, strlen(userCommandBuff));
 
-                n = write( sockFD, requestBuff, strlen(requestBuff));
-                if ( n < 0) {
-                    clientSystemCallError( client, "write", n);
-                }
+            /* write client request to the socket */
 
+            n = write( sockFD, requestBuff, strlen(requestBuff));
+            if ( n < 0) {
+                clientSystemCallError( client, "write", n);
+            }
 
-                memset( responseBuff, 0, MAXLEN); // init buffer with 0 for reading
-                /*reads the response from the server */
 
-                n = read( sockFD, responseBuff, MAXLEN-1);
-                if ( n < 0) {
-                    clientSystemCallError( client, "connect", n);
-                } else {
-                    /* log server response in client log */
-                    client->log_response( std::string(responseBuff));
-                }
+            memset( responseBuff, 0, MAXLEN); // init buffer with 0 for reading
+            /*reads the response from the server, until it closes the
+             * connection - a page of a RSVP list may come in several reads */
+            received = 0;
+            do {
+                n = read( sockFD, responseBuff + received,
+                          MAXLEN - 1 - received);
+                received += n > 0 ? n : 0;
+            } while ( (n > 0 || (n < 0 && errno == EINTR)) &&
+                      received < MAXLEN - 1);
+            if ( n < 0) {
+                clientSystemCallError( client, "connect", n);
+            } else {
+                /* log server response in client log */
+                client->log_response( std::string(responseBuff));
             }
 
             close( sockFD);
+
+            memset( requestBuff, 0, MAXLEN);
+            isValidCommand = client->takeNextPage( nextPage) &&
+                             client->validateCommand( nextPage.c_str());
+            snprintf( userCommandBuff, MAXLEN, "%s\n", nextPage.c_str());
         }
 
     }
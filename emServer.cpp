@@ -12,28 +12,100 @@
 #include <unistd.h>
 #include <stdlib.h>
 #include <string.h>
+#include <limits.h> // UINT_MAX
 #include <sys/types.h>
 #include <sys/time.h> //FD_SET, FD_ISSET, FD_ZERO macros
 #include <netinet/in.h>
 #include <sys/socket.h>
 #include <arpa/inet.h>  // inet_ntoa
+#include <sys/eventfd.h>
 #include <thread>
+#include <mutex>
+#include <vector>
+#include <map>
+#include <functional> // mem_fn
 
 #include "Server.h"
+#include "EpollReactor.h"
+#include "UringReactor.h"
+#include "ThreadPool.h"
 
-/* max number of pending connections */
-#define MAX_PEND_CONNECT 10
+/* default max number of pending connections of each listener */
+#define MAX_PEND_CONNECT SOMAXCONN
 #define MAX_CLIENTNAME 10
 #define MAXLEN 99999
 #define TRUE 1
 #define STDIN 0
-std::vector<std::thread> threads;
+/* names of the I/O engines that can be chosen with the -e flag */
+#define ENGINE_SELECT "select"
+#define ENGINE_EPOLL "epoll"
+#define ENGINE_URING "uring"
+/* execution modes of the mutating commands, chosen with the -m flag */
+#define MODE_LOCKS "locks"
+#define MODE_SEQUENCER "sequencer"
+#define USAGE "Usage: emServer portNum [-e select|epoll|uring] [-w workers] " \
+              "[-l listeners] [-q backlog] [-m locks|sequencer] [-t topMax] " \
+              "[-b budgetKB]"
 bool exitServer = false;
 
+/* select engine connections that wait for their next bytes in the select
+ * set - a worker hands a connection back (to parked) when its job is done */
+std::map<int /*socket*/, ClientConnection*> idleConnections;
+std::mutex parkedLock;
+std::vector<ClientConnection*> parked;
+int parkedFD = -1; /* eventfd that wakes select when a connection is parked */
 
-void handleRequest( int newSockFD)
+
+/**
+ * @brief: worker job - serve the bytes the client sent and hand the
+ * connection back to the select loop unless it was closed.
+ */
+void handleRequest( ClientConnection* conn)
 {
-    Server::handleClient( newSockFD);
+    uint64_t one = 1;
+
+    if ( conn->sock >= FD_SETSIZE) {
+        /* select can not wait on it - serve it on this worker until closed */
+        while ( Server::handleClient( *conn)) {}
+        delete conn;
+        return;
+    }
+
+    if ( !Server::handleClient( *conn)) {
+        delete conn;
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> guard( parkedLock);
+        parked.push_back( conn);
+    }
+    if ( write( parkedFD, &one, sizeof(one)) < 0 && errno != EAGAIN) {
+        Server::logServerError( "write", std::to_string( errno));
+    }
+}
+
+
+/**
+ * @brief: close the connections left waiting when the server exits - after
+ * the pool ran its last jobs.
+ */
+void closeConnections()
+{
+    std::map<int, ClientConnection*>::iterator it;
+    std::vector<ClientConnection*>::iterator parkedIt;
+
+    for ( it = idleConnections.begin(); it != idleConnections.end(); ++it) {
+        close( it->first);
+        delete it->second;
+    }
+    idleConnections.clear();
+
+    for ( parkedIt = parked.begin(); parkedIt != parked.end(); ++parkedIt) {
+        close( (*parkedIt)->sock);
+        delete *parkedIt;
+    }
+    parked.clear();
 }
 
 
@@ -47,31 +119,170 @@ void handleRequest( int newSockFD)
 void serverSystemError( int errCode, const char *func)
 {
     std::string funcSys( func);
-    std::string err = "ERROR" +  '\t' +funcSys +'\t' + std::to_string(errCode);
+    std::string err = "ERROR\t" + funcSys + '\t' + std::to_string(errCode);
     Server::logServer( err);
     exit(1);
 }
 
 /**
- * command line for running server:
- * ./emServer portNum
+ * @brief: run a command typed in the server stdin.
+ * @return: true if EXIT was typed.
  */
-int main( int argc, char *argv[])
+bool stdinCommand( const std::string& command, ThreadPool* pool)
 {
-    int masterSocket, newSockFD, portNum;
-    struct sockaddr_in servAddress, client_info;
+    if ( command.find( EXIT_COMMAND) != std::string::npos) {
+        return true;
+    }
+    if ( command.find( STATS_COMMAND) != std::string::npos) {
+        Server::logServer( "STATS\t" + pool->stats());
+        if ( !Server::getInstance().sequencerStats().empty()) {
+            Server::logServer( "STATS\t" +
+                               Server::getInstance().sequencerStats());
+        }
+        Server::logServer( "STATS\t" + ResponseCache::stats());
+        if ( !Server::getInstance().eventStats().empty()) {
+            Server::logServer( "STATS\t" +
+                               Server::getInstance().eventStats());
+        }
+    }
+    return false;
+}
+
+
+/**
+ * @brief: the original engine - select() on STDIN, the master socket and the
+ * idle client connections. a connection that has bytes to read is handled
+ * by a job on the worker pool, that parks it back in the select set when
+ * done - so idle sessions do not hold the workers.
+ */
+void runSelectLoop( int masterSocket, ThreadPool* pool)
+{
+    int newSockFD;
+    struct sockaddr_in client_info;
     char readbuf[MAXLEN];
-    int optval = TRUE, activity;
+    int activity;
     int max_sd;
+    uint64_t count;
     fd_set readfds; //set of socket descriptors
+    std::map<int, ClientConnection*>::iterator it;
+    std::vector<ClientConnection*>::iterator parkedIt;
+    ClientConnection* conn;
 
-    if ( argc < 2) {
-        fprintf( stdout, "Usage: emServer portNum");
-        exit( 1);
+    parkedFD = eventfd( 0, EFD_NONBLOCK);
+    if ( parkedFD < 0) {
+        serverSystemError( errno, "eventfd");
     }
 
-    Server& server = Server::getInstance();
-    server.initServer();
+    while ( !exitServer)
+    {
+        //clear the socket set
+        FD_ZERO(&readfds);
+        FD_SET( STDIN, &readfds); /* add STDIN to readfds*/
+
+        //add master socket to set
+        FD_SET( masterSocket, &readfds); /* add sockfd to readfds*/
+        max_sd = masterSocket;
+
+        FD_SET( parkedFD, &readfds);
+        max_sd = std::max( max_sd, parkedFD);
+        for ( it = idleConnections.begin(); it != idleConnections.end();
+              ++it) {
+            FD_SET( it->first, &readfds);
+            max_sd = std::max( max_sd, it->first);
+        }
+
+        /*wait for activity on one of the sockets,timeout is NULL,
+         * wait indefinitely*/
+        activity = select( max_sd + 1 , &readfds , NULL , NULL , NULL);
+
+        if ((activity < 0) && (errno!=EINTR)) {
+            serverSystemError( errno, "select");
+        }
+        if ( activity < 0) {
+            continue; /* the sets are undefined */
+        }
+
+        // pass the readable connections to the worker pool
+        for ( it = idleConnections.begin(); it != idleConnections.end(); ) {
+            if ( FD_ISSET( it->first, &readfds)) {
+                pool->submit( std::bind( handleRequest, it->second));
+                idleConnections.erase( it++);
+            } else {
+                ++it;
+            }
+        }
+
+        if ( FD_ISSET( parkedFD, &readfds)) {
+            if ( read( parkedFD, &count, sizeof(count)) < 0 &&
+                 errno != EAGAIN) {
+                serverSystemError( errno, "read");
+            }
+            std::lock_guard<std::mutex> guard( parkedLock);
+            for ( parkedIt = parked.begin(); parkedIt != parked.end();
+                  ++parkedIt) {
+                idleConnections[(*parkedIt)->sock] = *parkedIt;
+            }
+            parked.clear();
+        }
+
+        if ( FD_ISSET( masterSocket, &readfds)) {
+
+            socklen_t clientSize = sizeof(client_info);
+            newSockFD = accept( masterSocket, (struct sockaddr *) &client_info,
+                                &clientSize);
+
+            if ( newSockFD < 0) {
+                serverSystemError( newSockFD, "accept");
+            }
+
+            // wait for the request in the select set
+            conn = new ClientConnection( newSockFD);
+            if ( newSockFD >= FD_SETSIZE) {
+                pool->submit( std::bind( handleRequest, conn));
+            } else {
+                idleConnections[newSockFD] = conn;
+            }
+        }
+
+        else if ( FD_ISSET( STDIN, &readfds)) {
+            memset( readbuf, 0, MAXLEN);
+            fgets( readbuf, MAXLEN, stdin);
+            exitServer = stdinCommand( std::string( readbuf), pool);
+        }
+    }
+}
+
+
+/**
+ * @brief: read the commands typed in the server stdin while the event loops
+ * run on their own threads.
+ * @return: true if EXIT was typed, false if stdin was closed.
+ */
+bool readStdin( ThreadPool* pool)
+{
+    char readbuf[MAXLEN];
+
+    while ( fgets( readbuf, MAXLEN, stdin) != NULL)
+    {
+        if ( stdinCommand( std::string( readbuf), pool)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+
+/**
+ * @brief: open a listening socket on portNum. with reusePort several
+ * sockets listen on the same port and the kernel spreads the incoming
+ * connections between them.
+ * @return: the listening socket.
+ */
+int openListener( int portNum, int backlog, bool reusePort)
+{
+    struct sockaddr_in servAddress;
+    int optval = TRUE;
+    int masterSocket, res;
 
     masterSocket = socket( AF_INET, SOCK_STREAM, 0);
     if ( masterSocket < 0)
@@ -80,17 +291,23 @@ int main( int argc, char *argv[])
     }
 
     /* set master socket to allow multiple connections */
-    int res = setsockopt( masterSocket, SOL_SOCKET, SO_REUSEADDR,
-                          (char *) &optval, (int) sizeof(optval));
-     if( res < 0 )
-     {
-         serverSystemError( res, "setsockopt");
-     }
+    res = setsockopt( masterSocket, SOL_SOCKET, SO_REUSEADDR,
+                      (char *) &optval, (int) sizeof(optval));
+    if ( res < 0)
+    {
+        serverSystemError( res, "setsockopt");
+    }
 
+    if ( reusePort) {
+        res = setsockopt( masterSocket, SOL_SOCKET, SO_REUSEPORT,
+                          (char *) &optval, (int) sizeof(optval));
+        if ( res < 0)
+        {
+            serverSystemError( errno, "setsockopt");
+        }
+    }
 
     memset( (char *) &servAddress, 0, sizeof(struct sockaddr_in));
-
-    portNum = atoi( argv[1]);
     servAddress.sin_family = AF_INET;
     servAddress.sin_addr.s_addr = INADDR_ANY;
     servAddress.sin_port = htons( portNum);
@@ -102,72 +319,171 @@ int main( int argc, char *argv[])
         serverSystemError( res, "bind");
     }
 
-    res = listen( masterSocket, MAX_PEND_CONNECT);
+    res = listen( masterSocket, backlog);
     if ( res < 0 ){
         serverSystemError( res, "listen");
     }
-    printf("Listener on port %d. Waiting for connections :)\n", portNum);
+    return masterSocket;
+}
 
-    while ( !exitServer)
+
+/**
+ * @brief: create the event loop of the engine on masterSocket. when
+ * io_uring can not be used engine is set to epoll.
+ */
+Reactor* newReactor( std::string& engine, int masterSocket, ThreadPool* pool)
+{
+    Reactor* reactor;
+
+    if ( engine == ENGINE_URING) {
+        reactor = new UringReactor( masterSocket, pool);
+        if ( reactor->init()) {
+            return reactor;
+        }
+        /* the kernel lacks io_uring (or a feature in use) */
+        Server::logServer( "io_uring is not available - using epoll");
+        delete reactor;
+        engine = ENGINE_EPOLL;
+    }
+
+    reactor = new EpollReactor( masterSocket, pool);
+    if ( !reactor->init()) {
+        serverSystemError( errno, "epoll_create1");
+    }
+    return reactor;
+}
+
+
+/**
+ * command line for running server:
+ * ./emServer portNum [-e select|epoll|uring] [-w workers] [-l listeners]
+ *                    [-q backlog] [-m locks|sequencer] [-t topMax]
+ *                    [-b budgetKB]
+ * workers defaults to the number of cores. each of the listeners has its
+ * own listening socket (SO_REUSEPORT) and event loop thread - epoll and
+ * uring engines only. in sequencer mode the mutating commands are applied
+ * by a single writer thread instead of the workers. topMax is the max count
+ * of GET_TOP (at least 5, for GET_TOP_5). past budgetKB of events in memory
+ * the cold events are spilled to a file and read back when needed.
+ */
+int main( int argc, char *argv[])
+{
+    int portNum, opt, i;
+    int numListeners = 1;
+    int backlog = MAX_PEND_CONNECT;
+    int newestMax = DEFAULT_NEWEST_MAX;
+    long budgetKB = 0;
+    long numWorkers = 0;
+    char* end;
+    std::string engine = ENGINE_SELECT;
+    std::string mode = MODE_LOCKS;
+    ThreadPool* pool;
+    std::vector<int> listeners;
+    std::vector<Reactor*> reactors;
+    std::vector<std::thread> loops;
+
+    while ( (opt = getopt( argc, argv, "e:w:l:q:m:t:b:")) != -1)
     {
-        //clear the socket set
-        FD_ZERO(&readfds);
-        FD_SET( STDIN, &readfds); /* add STDIN to readfds*/
+        switch ( opt)
+        {
+            case 'e':
+                engine = std::string( optarg);
+                break;
 
-        //add master socket to set
-        FD_SET( masterSocket, &readfds); /* add sockfd to readfds*/
-        max_sd = masterSocket;
+            case 'w':
+                numWorkers = strtol( optarg, &end, 10);
+                if ( end == optarg || *end != '\0') {
+                    numWorkers = -1; /* not a number */
+                }
+                break;
 
-        /*wait for activity on one of the sockets,timeout is NULL,
-         * wait indefinitely*/
-        activity = select( max_sd + 1 , &readfds , NULL , NULL , NULL);
+            case 'l':
+                numListeners = atoi( optarg);
+                break;
 
-        if ((activity < 0) && (errno!=EINTR)) {
-            serverSystemError( errno, "select");
+            case 'q':
+                backlog = atoi( optarg);
+                break;
+
+            case 'm':
+                mode = std::string( optarg);
+                break;
+
+            case 't':
+                newestMax = atoi( optarg);
+                break;
+
+            case 'b':
+                budgetKB = atol( optarg);
+                break;
+
+            default:
+                fprintf( stdout, USAGE);
+                exit( 1);
         }
+    }
 
-        if ( FD_ISSET( masterSocket, &readfds)) {
+    if ( optind >= argc || (engine != ENGINE_SELECT &&
+                            engine != ENGINE_EPOLL && engine != ENGINE_URING) ||
+         (mode != MODE_LOCKS && mode != MODE_SEQUENCER) ||
+         numWorkers < 0 || numWorkers > UINT_MAX ||
+         numListeners < 1 || backlog < 1 ||
+         newestMax < TOP_5 || newestMax > MAX_NEWEST_MAX || budgetKB < 0 ||
+         (engine == ENGINE_SELECT && numListeners > 1)) {
+        fprintf( stdout, USAGE);
+        exit( 1);
+    }
 
-            socklen_t clientSize = sizeof(client_info);
-            newSockFD = accept( masterSocket, (struct sockaddr *) &client_info,
-                                &clientSize);
+    Server& server = Server::getInstance();
+    if ( !server.initServer( mode == MODE_SEQUENCER, newestMax,
+                             (size_t) budgetKB * 1024)) {
+        serverSystemError( errno, "mkstemp");
+    }
 
-            if ( newSockFD < 0) {
-                serverSystemError( newSockFD, "accept");
-            }
+    portNum = atoi( argv[optind]);
+    for ( i = 0; i < numListeners; ++i) {
+        listeners.push_back( openListener( portNum, backlog,
+                                           numListeners > 1));
+    }
+    printf("Listener on port %d. Waiting for connections :)\n", portNum);
+
+    pool = new ThreadPool( (unsigned int) numWorkers);
 
-            /* inform user of connected_ip and port*/
-            /*
-            char *connected_ip = inet_ntoa(client_info.sin_addr);
-            int port = ntohs( client_info.sin_port);
-            printf("New connection on socket fd is: %d, ip is: %s, port: %d\n",
-                    newSockFD , connected_ip , port);
-            */
-            // spawn new thread to handle request
-            threads.push_back( std::thread( handleRequest, newSockFD));
+    if ( engine == ENGINE_SELECT) {
+        runSelectLoop( listeners[0], pool);
+        delete pool; /* runs the pending requests and joins the workers */
+        closeConnections();
+    } else {
+        for ( i = 0; i < numListeners; ++i) {
+            reactors.push_back( newReactor( engine, listeners[i], pool));
+        }
+        for ( i = 0; i < numListeners; ++i) {
+            loops.push_back( std::thread( &Reactor::run, reactors[i]));
         }
 
-        else if ( FD_ISSET( STDIN, &readfds)) {
-            memset( readbuf, 0, MAXLEN);
-            fgets( readbuf, MAXLEN, stdin);
-            std::string command( readbuf);
-            size_t hasExit = command.find("EXIT");
-            if ( hasExit != std::string::npos) {
-                exitServer = true;
+        /* a closed stdin leaves the server running until it is killed */
+        if ( readStdin( pool)) {
+            for ( i = 0; i < numListeners; ++i) {
+                reactors[i]->stop();
             }
         }
-    }
+        for ( i = 0; i < numListeners; ++i) {
+            loops[i].join();
+        }
 
-    /* if EXIT was types: call join() on each thread in turn*/
-    if ( exitServer) {
-        /* end of while */
+        /* wait for running jobs - they post responses to the reactors */
+        delete pool;
+        for ( i = 0; i < numListeners; ++i) {
+            delete reactors[i];
+        }
+    }
 
-        std::for_each( threads.begin(), threads.end(),
-                       std::mem_fn( &std::thread::join));
-        close( masterSocket);
-        Server::exitServer();
-        exit(0);
+    /* EXIT was typed */
+    for ( i = 0; i < numListeners; ++i) {
+        close( listeners[i]);
     }
+    Server::exitServer();
+    exit(0);
 
     return 0; /* we never get here */
 }